@@ -0,0 +1,150 @@
+// Benchmark of the distance field in front of the exact collision queries.
+// Build with: python3 build.py clearance_bench
+// Run with:   ./clearance_bench [map files...]   (defaults to the maps in this directory)
+//
+// For each map and robot radius, the same seeded points and short segments as
+// collision_bench are tested exactly, and again with the distance field first, reporting
+// the fraction of queries the field settles without an exact test. A query the field
+// calls free while the exact test finds a collision is counted as wrong, which should
+// never happen. A planner run is also counted the same way, as its queries cluster
+// around the tree rather than spreading evenly.
+#include "RRT.hpp"
+#include "DistanceField.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int QUERY_COUNT = 200000;
+const float WORKSPACE_X = 640;
+const float WORKSPACE_Y = 480;
+const float MAX_SEGMENT_LENGTH = 70;
+
+double nanosecondsSince(std::chrono::steady_clock::time_point start, int count){
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+struct Counts{
+    long queries = 0;
+    long exact = 0;
+};
+
+// ClearanceCollision, counting how many queries needed the exact test. The planner keeps
+// its own copy of the backend, so the counts live outside it.
+struct CountingCollision{
+    using State = Vector2f;
+
+    ClearanceCollision<2, float> inner;
+    Counts* counts;
+
+    bool inCollision(const State& s) const{
+        counts->queries++;
+        counts->exact += !inner.field().provesFree(s, inner.radius());
+        return inner.inCollision(s);
+    }
+
+    bool segmentInCollision(const State& a, const State& b) const{
+        counts->queries++;
+        counts->exact += !inner.field().provesFree(a, b, inner.radius());
+        return inner.segmentInCollision(a, b);
+    }
+
+    const Obstacles& obstacles() const{
+        return inner.obstacles();
+    }
+};
+
+void bench(const std::string& map){
+    Obstacles obs(map);
+    obs.decomposeConvex();
+
+    auto buildStart = std::chrono::steady_clock::now();
+    DistanceField field(obs, WORKSPACE_X, WORKSPACE_Y);
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    std::printf("%s, field of %.0f x %.0f cells built in %.2f ms\n", map.c_str(), WORKSPACE_X / field.cellSize(),
+                WORKSPACE_Y / field.cellSize(), buildMs);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> x(0, WORKSPACE_X), y(0, WORKSPACE_Y);
+    std::uniform_real_distribution<float> offset(-MAX_SEGMENT_LENGTH, MAX_SEGMENT_LENGTH);
+    std::vector<Vector2f> points, starts, ends;
+    for(int i = 0; i < QUERY_COUNT; i++){
+        points.push_back({x(rng), y(rng)});
+        Vector2f a{x(rng), y(rng)};
+        starts.push_back(a);
+        ends.push_back({a.x + offset(rng), a.y + offset(rng)});
+    }
+
+    for(float radius : {0.0f, 5.0f}){
+        int pointProven = 0, pointWrong = 0, segmentProven = 0, segmentWrong = 0;
+        for(int i = 0; i < QUERY_COUNT; i++){
+            if(field.provesFree(points[i], radius)){
+                pointProven++;
+                pointWrong += obs.inObstacles(points[i], radius);
+            }
+            if(field.provesFree(starts[i], ends[i], radius)){
+                segmentProven++;
+                segmentWrong += obs.segmentInObstacles(starts[i], ends[i], radius);
+            }
+        }
+
+        // Hit counts of the exact and field first runs, which must agree.
+        ClearanceCollision<2, float> collision(obs, field, radius);
+        int exactHits = 0, fieldHits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < QUERY_COUNT; i++){
+            exactHits += obs.inObstacles(points[i], radius);
+        }
+        double pointExactNs = nanosecondsSince(start, QUERY_COUNT);
+        start = std::chrono::steady_clock::now();
+        for(int i = 0; i < QUERY_COUNT; i++){
+            fieldHits += collision.inCollision(points[i]);
+        }
+        double pointFieldNs = nanosecondsSince(start, QUERY_COUNT);
+        std::printf("  radius %.0f  points:   %5.1f%% exact tests avoided, %6.1f -> %6.1f ns/query, hits %d/%d, %d wrong\n",
+                    radius, 100.0 * pointProven / QUERY_COUNT, pointExactNs, pointFieldNs, fieldHits, exactHits, pointWrong);
+
+        exactHits = fieldHits = 0;
+        start = std::chrono::steady_clock::now();
+        for(int i = 0; i < QUERY_COUNT; i++){
+            exactHits += obs.segmentInObstacles(starts[i], ends[i], radius);
+        }
+        double segmentExactNs = nanosecondsSince(start, QUERY_COUNT);
+        start = std::chrono::steady_clock::now();
+        for(int i = 0; i < QUERY_COUNT; i++){
+            fieldHits += collision.segmentInCollision(starts[i], ends[i]);
+        }
+        double segmentFieldNs = nanosecondsSince(start, QUERY_COUNT);
+        std::printf("  radius %.0f  segments: %5.1f%% exact tests avoided, %6.1f -> %6.1f ns/query, hits %d/%d, %d wrong\n",
+                    radius, 100.0 * segmentProven / QUERY_COUNT, segmentExactNs, segmentFieldNs, fieldHits, exactHits, segmentWrong);
+
+        Counts counts;
+        RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>, CountingCollision>
+            planner(Vector2f(0, 0), Vector2f(WORKSPACE_X, WORKSPACE_Y), CountingCollision{collision, &counts},
+                    {10, 10}, {580, 460}, 20, 70, 30);
+        planner.beginSearch();
+        planner.step(3000);
+        std::printf("  radius %.0f  planner:  %5.1f%% exact tests avoided over %ld queries\n",
+                    radius, 100.0 * (counts.queries - counts.exact) / std::max(1L, counts.queries), counts.queries);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    std::vector<std::string> maps;
+    for(int i = 1; i < argc; i++){
+        maps.push_back(argv[i]);
+    }
+    if(maps.empty()){
+        maps = {"small_obstacles.txt", "large_spread_out.txt", "unreachable_corner.txt"};
+    }
+    for(const std::string& map : maps){
+        bench(map);
+    }
+    return 0;
+}
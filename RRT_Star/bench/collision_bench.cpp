@@ -0,0 +1,118 @@
+// Benchmark of the obstacle collision queries used by the planner.
+// Build with: python3 build.py collision_bench
+// Run with:   ./collision_bench [map files...]   (defaults to the maps in this directory)
+//
+// Every map is queried with the same seeded stream of points and short segments,
+// once against the triangulated polygons and once against their convex decomposition.
+#include "Obstacles.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int QUERY_COUNT = 200000;
+const float WORKSPACE_X = 640;
+const float WORKSPACE_Y = 480;
+const float MAX_SEGMENT_LENGTH = 70;
+
+struct Queries{
+    std::vector<Vector2f> points;
+    std::vector<Vector2f> segmentStarts;
+    std::vector<Vector2f> segmentEnds;
+};
+
+Queries makeQueries(unsigned seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> x(0, WORKSPACE_X), y(0, WORKSPACE_Y);
+    std::uniform_real_distribution<float> offset(-MAX_SEGMENT_LENGTH, MAX_SEGMENT_LENGTH);
+
+    Queries q;
+    for(int i = 0; i < QUERY_COUNT; i++){
+        q.points.push_back({x(rng), y(rng)});
+        Vector2f a{x(rng), y(rng)};
+        q.segmentStarts.push_back(a);
+        q.segmentEnds.push_back({a.x + offset(rng), a.y + offset(rng)});
+    }
+    return q;
+}
+
+struct Timing{
+    double pointNs;
+    double segmentNs;
+    int pointHits;
+    int segmentHits;
+};
+
+Timing run(const Obstacles& obs, const Queries& q){
+    Timing t{0, 0, 0, 0};
+
+    auto start = std::chrono::steady_clock::now();
+    for(const Vector2f& p : q.points){
+        t.pointHits += obs.inObstacles(p);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < q.segmentStarts.size(); i++){
+        t.segmentHits += obs.segmentInObstacles(q.segmentStarts[i], q.segmentEnds[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    t.pointNs = std::chrono::duration<double, std::nano>(middle - start).count() / q.points.size();
+    t.segmentNs = std::chrono::duration<double, std::nano>(end - middle).count() / q.segmentStarts.size();
+    return t;
+}
+
+size_t countTriangles(const Obstacles& obs){
+    size_t count = 0;
+    for(const Polygon& polygon : obs.polygons()){
+        count += polygon.triangles.size();
+    }
+    return count;
+}
+
+size_t countConvexParts(const Obstacles& obs){
+    size_t count = 0;
+    for(const Polygon& polygon : obs.polygons()){
+        count += polygon.convexParts.size();
+    }
+    return count;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    std::vector<std::string> maps;
+    for(int i = 1; i < argc; i++){
+        maps.push_back(argv[i]);
+    }
+    if(maps.empty()){
+        maps = {"small_obstacles.txt", "large_spread_out.txt", "unreachable_corner.txt"};
+    }
+
+    Queries queries = makeQueries(42);
+    bool mismatch = false;
+
+    std::printf("%-26s %-10s %10s %12s %12s\n", "map", "backend", "primitives", "point ns", "segment ns");
+    for(const std::string& map : maps){
+        Obstacles triangles(map);
+        Obstacles convex(map);
+        convex.decomposeConvex();
+
+        Timing t = run(triangles, queries);
+        Timing c = run(convex, queries);
+
+        std::printf("%-26s %-10s %10zu %12.1f %12.1f\n", map.c_str(), "triangles", countTriangles(triangles), t.pointNs, t.segmentNs);
+        std::printf("%-26s %-10s %10zu %12.1f %12.1f\n", "", "convex", countConvexParts(convex), c.pointNs, c.segmentNs);
+        std::printf("%-26s %-10s %10s %11.2fx %11.2fx\n", "", "speedup", "", t.pointNs / c.pointNs, t.segmentNs / c.segmentNs);
+
+        if(t.pointHits != c.pointHits || t.segmentHits != c.segmentHits){
+            std::printf("  hit counts differ: points %d vs %d, segments %d vs %d\n", t.pointHits, c.pointHits, t.segmentHits, c.segmentHits);
+            mismatch = true;
+        }
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,585 @@
+// Randomized differential check of the accelerated collision and nearest neighbor backends.
+// Build with: python3 build.py differential_check
+// Run with:   ./differential_check [seed] [maps]   (defaults to seed 1 and 100 maps)
+//
+// Seeded random polygon maps and query streams are answered by a plain reference and by
+// every accelerated backend, and any answer that differs is reported. For collisions the
+// reference tests every polygon's triangles in turn, with no broadphase, against the
+// Obstacles grid over the triangles and over the convex parts, ClearanceCollision and
+// QuadTreeCollision, for a point and a disc robot. For nearest neighbors it is
+// LinearNearest against KdTreeNearest over streams of adds, removes and nearest, radius
+// and k nearest queries. Last, the planner runs with each backend on some of the maps and
+// must reach the same path.
+//
+// The first few mismatches of each backend are shrunk before they are printed: polygons
+// and vertices are dropped and the segment shortened while the backend still disagrees,
+// and an operation stream loses every operation it can. A collision reproducer is printed
+// as an obstacle file. The time each backend spends answering goes into the same report,
+// so a faster backend is only taken as one that also agrees. Exits with 1 on any mismatch.
+#include "RRT.hpp"
+#include "DistanceField.hpp"
+#include "QuadTree.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float WORKSPACE_X = 640;
+const float WORKSPACE_Y = 480;
+const int QUERIES_PER_MAP = 4000;
+const float MAX_SEGMENT_LENGTH = 70;
+const float MAX_ROBOT_RADIUS = 15;
+const float FIELD_CELL_SIZE = 2;
+const float QUADTREE_MIN_CELL = 4;
+const int STREAM_COUNT = 40;
+const int OPERATIONS_PER_STREAM = 3000;
+const int PLAN_EVERY = 10;          // The planners run on every tenth map.
+const int PLAN_ITERATIONS = 1500;
+const int REPRODUCERS_PER_BACKEND = 3;
+
+double secondsSince(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ---------------------------------------------------------------------------------------
+// Collision
+
+using Map = std::vector<std::vector<Vector2f>>;
+
+// A segment query, or a point query when point is set and b is ignored.
+struct Query{
+    Vector2f a;
+    Vector2f b;
+    bool point;
+};
+
+enum Backend{REFERENCE, TRIANGLES, CONVEX_PARTS, CLEARANCE, QUADTREE, BACKEND_COUNT};
+
+const char* BACKEND_NAMES[BACKEND_COUNT] = {
+    "reference (every polygon)", "Obstacles (triangles)", "Obstacles (convex parts)", "ClearanceCollision", "QuadTreeCollision"
+};
+
+Obstacles buildObstacles(const Map& map, bool decompose){
+    std::vector<float> xy;
+    std::vector<uint32_t> counts;
+    for(const std::vector<Vector2f>& polygon : map){
+        for(const Vector2f& v : polygon){
+            xy.push_back(v.x);
+            xy.push_back(v.y);
+        }
+        counts.push_back(polygon.size());
+    }
+    Obstacles obs(xy.data(), counts.data(), counts.size());
+    if(decompose){
+        obs.decomposeConvex();
+    }
+    return obs;
+}
+
+// Every backend for one map and robot radius.
+struct CollisionSetup{
+    float radius;
+    Obstacles triangles;
+    Obstacles convex;
+    DistanceField field;
+    OccupancyQuadTree tree;
+
+    CollisionSetup(const Map& map, float radius)
+        : radius(radius), triangles(buildObstacles(map, false)), convex(buildObstacles(map, true)),
+          field(convex, WORKSPACE_X, WORKSPACE_Y, FIELD_CELL_SIZE),
+          tree(convex, {0, 0}, {WORKSPACE_X, WORKSPACE_Y}, QUADTREE_MIN_CELL){
+    }
+
+    CollisionSetup(const CollisionSetup&) = delete;
+    CollisionSetup& operator=(const CollisionSetup&) = delete;
+
+    // The reference shares the geometry kernels with the backends, so a disagreement points
+    // at the structure in front of them rather than at rounding in the kernels.
+    bool reference(const Query& q) const{
+        Vector2f b = q.point ? q.a : q.b;
+        for(const Polygon& polygon : triangles.polygons()){
+            if(q.point ? polygon.contains(q.a) : polygon.containsSegment(q.a, b)){
+                return true;
+            }
+            if(radius > 0){
+                for(size_t i = 0; i < polygon.vertices.size(); i++){
+                    if(SegmentDistance(q.a, b, polygon.vertices[i], polygon.vertices[(i + 1) % polygon.vertices.size()]) <= radius){
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool answer(int backend, const Query& q) const{
+        switch(backend){
+        case REFERENCE:
+            return reference(q);
+        case TRIANGLES:
+            return q.point ? triangles.inObstacles(q.a, radius) : triangles.segmentInObstacles(q.a, q.b, radius);
+        case CONVEX_PARTS:
+            return q.point ? convex.inObstacles(q.a, radius) : convex.segmentInObstacles(q.a, q.b, radius);
+        case CLEARANCE:{
+            ClearanceCollision<2, float> collision(convex, field, radius);
+            return q.point ? collision.inCollision(q.a) : collision.segmentInCollision(q.a, q.b);
+        }
+        default:{
+            QuadTreeCollision<2, float> collision(tree, radius);
+            return q.point ? collision.inCollision(q.a) : collision.segmentInCollision(q.a, q.b);
+        }
+        }
+    }
+};
+
+// Star shaped polygons, a vertex in each of n equal wedges around the center, and axis
+// aligned rectangles on whole coordinates like the hand made maps, overlapping freely.
+Map makeMap(std::mt19937& rng){
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::uniform_int_distribution<int> polygonCount(1, 30);
+    std::uniform_int_distribution<int> vertexCount(3, 14);
+    Map map;
+    for(int count = polygonCount(rng); count > 0; count--){
+        Vector2f center(WORKSPACE_X * unit(rng), WORKSPACE_Y * unit(rng));
+        float size = 5 + 75 * unit(rng);
+        std::vector<Vector2f> polygon;
+        if(unit(rng) < 0.25f){
+            float x0 = std::round(center.x), y0 = std::round(center.y);
+            float x1 = x0 + std::round(size), y1 = y0 + std::round(0.3f * size + size * unit(rng));
+            polygon = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+        }else{
+            int n = vertexCount(rng);
+            for(int i = 0; i < n; i++){
+                float angle = 2 * std::numbers::pi_v<float> * (i + 0.8f * unit(rng)) / n;
+                float r = size * (0.3f + 0.7f * unit(rng));
+                polygon.push_back({center.x + r * std::cos(angle), center.y + r * std::sin(angle)});
+            }
+        }
+        map.push_back(polygon);
+    }
+    return map;
+}
+
+// Uniform points and short segments, and as many starting on a polygon's vertex or edge,
+// where the boundary rules of the backends have to agree.
+std::vector<Query> makeQueries(std::mt19937& rng, const Map& map){
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::uniform_real_distribution<float> offset(-MAX_SEGMENT_LENGTH, MAX_SEGMENT_LENGTH);
+    std::uniform_int_distribution<size_t> polygonIndex(0, map.size() - 1);
+    std::vector<Query> queries;
+    for(int i = 0; i < QUERIES_PER_MAP; i++){
+        Vector2f a(WORKSPACE_X * unit(rng), WORKSPACE_Y * unit(rng));
+        float kind = unit(rng);
+        if(kind < 0.5f){
+            const std::vector<Vector2f>& polygon = map[polygonIndex(rng)];
+            size_t v = std::uniform_int_distribution<size_t>(0, polygon.size() - 1)(rng);
+            a = polygon[v];
+            if(kind < 0.25f){
+                const Vector2f& next = polygon[(v + 1) % polygon.size()];
+                a = a + (next - a) * unit(rng);
+            }
+        }
+        Vector2f b(std::clamp(a.x + offset(rng), 0.0f, WORKSPACE_X), std::clamp(a.y + offset(rng), 0.0f, WORKSPACE_Y));
+        queries.push_back({a, b, unit(rng) < 0.3f});
+    }
+    return queries;
+}
+
+// True if the backend disagrees with the reference. Maps that no longer triangulate, as
+// vertices are dropped, count as agreeing.
+bool disagrees(const Map& map, float radius, int backend, const Query& q){
+    try{
+        CollisionSetup setup(map, radius);
+        return setup.answer(REFERENCE, q) != setup.answer(backend, q);
+    }catch(const std::exception&){
+        return false;
+    }
+}
+
+// Drop polygons, then vertices, then shorten the segment from either end, keeping each
+// change that leaves the backend disagreeing.
+void minimize(Map& map, float radius, int backend, Query& q){
+    for(size_t i = map.size(); i-- > 0 && map.size() > 1;){
+        Map smaller = map;
+        smaller.erase(smaller.begin() + i);
+        if(disagrees(smaller, radius, backend, q)){
+            map = smaller;
+        }
+    }
+    for(std::vector<Vector2f>& polygon : map){
+        for(size_t i = polygon.size(); i-- > 0 && polygon.size() > 3;){
+            Vertex removed = polygon[i];
+            polygon.erase(polygon.begin() + i);
+            if(!disagrees(map, radius, backend, q)){
+                polygon.insert(polygon.begin() + i, removed);
+            }
+        }
+    }
+    for(int step = 0; step < 24 && !q.point; step++){
+        Query shorter = q;
+        if(step % 2 == 0){
+            shorter.b = CreateMidpoint(q.a, q.b);
+        }else{
+            shorter.a = CreateMidpoint(q.a, q.b);
+        }
+        if(disagrees(map, radius, backend, shorter)){
+            q = shorter;
+        }
+    }
+}
+
+void printReproducer(const Map& map, float radius, int backend, const Query& q){
+    CollisionSetup setup(map, radius);
+    std::printf("  %s says %s, the reference says %s\n", BACKEND_NAMES[backend],
+                setup.answer(backend, q) ? "collision" : "free", setup.answer(REFERENCE, q) ? "collision" : "free");
+    if(q.point){
+        std::printf("    point (%.9g, %.9g), robot radius %.9g\n", q.a.x, q.a.y, radius);
+    }else{
+        std::printf("    segment (%.9g, %.9g) to (%.9g, %.9g), robot radius %.9g\n", q.a.x, q.a.y, q.b.x, q.b.y, radius);
+    }
+    std::printf("    map of %zu polygons as an obstacle file:\n", map.size());
+    for(size_t i = 0; i < map.size(); i++){
+        for(const Vector2f& v : map[i]){
+            std::printf("      %.9g %.9g\n", v.x, v.y);
+        }
+        if(i + 1 < map.size()){
+            std::printf("\n");
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// Nearest neighbors
+
+using Metric = EuclideanMetric<2, float>;
+
+enum class OperationKind{ADD, REMOVE, NEAREST, WITHIN_RADIUS, K_NEAREST};
+
+struct Operation{
+    OperationKind kind;
+    int index;       //< Node index added or removed.
+    Vector2f p;      //< State added, or the query point.
+    float radius;
+    int k;
+};
+
+// Adds, including repeated states, removes, and queries at random points and at stored
+// states, with radii that sometimes fall exactly on a stored state's distance.
+std::vector<Operation> makeStream(std::mt19937& rng){
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::vector<Operation> ops;
+    std::vector<Vector2f> states;
+    std::vector<int> live;
+    std::vector<int> freeIndices;
+    for(int i = 0; i < OPERATIONS_PER_STREAM; i++){
+        float kind = unit(rng);
+        Vector2f p(WORKSPACE_X * unit(rng), WORKSPACE_Y * unit(rng));
+        if(!states.empty() && unit(rng) < 0.15f){
+            p = states[std::uniform_int_distribution<size_t>(0, states.size() - 1)(rng)];
+        }
+        if(kind < 0.5f || live.empty()){
+            int index = states.size();
+            if(!freeIndices.empty()){
+                index = freeIndices.back();
+                freeIndices.pop_back();
+                states[index] = p;
+            }else{
+                states.push_back(p);
+            }
+            live.push_back(index);
+            ops.push_back({OperationKind::ADD, index, p, 0, 0});
+        }else if(kind < 0.65f){
+            size_t which = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+            int index = live[which];
+            live.erase(live.begin() + which);
+            freeIndices.push_back(index);
+            ops.push_back({OperationKind::REMOVE, index, {}, 0, 0});
+        }else{
+            float radius = 60 * unit(rng);
+            if(unit(rng) < 0.3f){
+                radius = Metric::distance(p, states[live[std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng)]]);
+            }
+            int k = std::uniform_int_distribution<int>(1, 12)(rng);
+            OperationKind query = kind < 0.75f ? OperationKind::NEAREST : kind < 0.9f ? OperationKind::WITHIN_RADIUS : OperationKind::K_NEAREST;
+            ops.push_back({query, -1, p, radius, k});
+        }
+    }
+    return ops;
+}
+
+// Run the stream through both indexes, skipping operations a shortened stream made invalid.
+// Returns the position of the first query they answer differently, describing it in what,
+// or -1 if they always agree.
+int firstMismatch(const std::vector<Operation>& ops, std::string* what){
+    LinearNearest<2, float, Metric> linear;
+    KdTreeNearest<2, float> tree;
+    std::vector<Vector2f> states;
+    std::vector<char> live;
+    std::vector<int> a, b;
+    char text[256];
+    for(size_t i = 0; i < ops.size(); i++){
+        const Operation& op = ops[i];
+        if(op.kind == OperationKind::ADD){
+            if(size_t(op.index) >= live.size()){
+                live.resize(op.index + 1, 0);
+                states.resize(op.index + 1);
+            }
+            if(!live[op.index]){
+                live[op.index] = 1;
+                states[op.index] = op.p;
+                linear.add(op.index, op.p);
+                tree.add(op.index, op.p);
+            }
+            continue;
+        }
+        if(op.kind == OperationKind::REMOVE){
+            if(size_t(op.index) < live.size() && live[op.index]){
+                live[op.index] = 0;
+                linear.remove(op.index);
+                tree.remove(op.index);
+            }
+            continue;
+        }
+
+        bool same = true;
+        if(op.kind == OperationKind::NEAREST){
+            int na = linear.nearest(op.p);
+            int nb = tree.nearest(op.p);
+            // Ties may pick different states at the same distance.
+            same = na == nb || (na >= 0 && nb >= 0 && Metric::distance(op.p, states[na]) == Metric::distance(op.p, states[nb]));
+            std::snprintf(text, sizeof(text), "nearest: LinearNearest gives %d, KdTreeNearest gives %d", na, nb);
+        }else if(op.kind == OperationKind::WITHIN_RADIUS){
+            linear.withinRadius(op.p, op.radius, a);
+            tree.withinRadius(op.p, op.radius, b);
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            same = a == b;
+            std::snprintf(text, sizeof(text), "withinRadius %.9g: LinearNearest finds %zu, KdTreeNearest finds %zu",
+                          op.radius, a.size(), b.size());
+        }else{
+            linear.kNearest(op.p, op.k, a);
+            tree.kNearest(op.p, op.k, b);
+            same = a.size() == b.size();
+            for(size_t j = 0; same && j < a.size(); j++){
+                same = Metric::distance(op.p, states[a[j]]) == Metric::distance(op.p, states[b[j]]);
+            }
+            std::snprintf(text, sizeof(text), "kNearest %d: LinearNearest and KdTreeNearest differ in distances", op.k);
+        }
+        if(!same){
+            if(what != nullptr){
+                *what = text;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Cut the stream at the mismatch, then remove every run of operations, halving the length
+// of the runs tried, that leaves a mismatch.
+std::vector<Operation> minimize(std::vector<Operation> ops, int mismatch){
+    ops.resize(mismatch + 1);
+    for(size_t run = ops.size() / 2; run >= 1; run /= 2){
+        for(size_t start = 0; start < ops.size();){
+            std::vector<Operation> shorter(ops.begin(), ops.begin() + start);
+            shorter.insert(shorter.end(), ops.begin() + std::min(ops.size(), start + run), ops.end());
+            int found = firstMismatch(shorter, nullptr);
+            if(found >= 0){
+                shorter.resize(found + 1);
+                ops = shorter;
+            }else{
+                start += run;
+            }
+        }
+    }
+    return ops;
+}
+
+void printStream(const std::vector<Operation>& ops){
+    for(const Operation& op : ops){
+        switch(op.kind){
+        case OperationKind::ADD:
+            std::printf("      add %d (%.9g, %.9g)\n", op.index, op.p.x, op.p.y);
+            break;
+        case OperationKind::REMOVE:
+            std::printf("      remove %d\n", op.index);
+            break;
+        case OperationKind::NEAREST:
+            std::printf("      nearest (%.9g, %.9g)\n", op.p.x, op.p.y);
+            break;
+        case OperationKind::WITHIN_RADIUS:
+            std::printf("      withinRadius (%.9g, %.9g) %.9g\n", op.p.x, op.p.y, op.radius);
+            break;
+        case OperationKind::K_NEAREST:
+            std::printf("      kNearest (%.9g, %.9g) %d\n", op.p.x, op.p.y, op.k);
+            break;
+        }
+    }
+}
+
+// Seconds to run the stream through one index alone.
+template <typename Nearest>
+double timeStream(const std::vector<Operation>& ops){
+    Nearest nearest;
+    std::vector<int> out;
+    long sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(const Operation& op : ops){
+        switch(op.kind){
+        case OperationKind::ADD:
+            nearest.add(op.index, op.p);
+            break;
+        case OperationKind::REMOVE:
+            nearest.remove(op.index);
+            break;
+        case OperationKind::NEAREST:
+            sink += nearest.nearest(op.p);
+            break;
+        case OperationKind::WITHIN_RADIUS:
+            nearest.withinRadius(op.p, op.radius, out);
+            sink += out.size();
+            break;
+        case OperationKind::K_NEAREST:
+            nearest.kNearest(op.p, op.k, out);
+            sink += out.size();
+            break;
+        }
+    }
+    double seconds = secondsSince(start);
+    return sink == -1 ? 0 : seconds;
+}
+
+// ---------------------------------------------------------------------------------------
+// Planners
+
+// Iterations and cost of the path found, or -1 iterations when the start is in an obstacle.
+template <typename Nearest, typename Collision>
+std::pair<int, float> plan(Collision collision){
+    try{
+        RRTStarN<2, float, Metric, Nearest, Collision> planner({0, 0}, {WORKSPACE_X, WORKSPACE_Y}, collision,
+                                                              {10, 10}, {580, 460}, 20, 70, 30, PLAN_ITERATIONS);
+        planner.setSeed(1);
+        planner.findBestPath();
+        return {planner.iterations(), planner.getCost()};
+    }catch(const RRTStartConfigExcption&){
+        return {-1, 0};
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    unsigned seed = argc > 1 ? std::atoi(argv[1]) : 1;
+    int mapCount = argc > 2 ? std::atoi(argv[2]) : 100;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0, 1);
+
+    long queryCount = 0;
+    long mismatches[BACKEND_COUNT] = {};
+    double seconds[BACKEND_COUNT] = {};
+    long planMismatches = 0;
+    int plans = 0;
+
+    std::printf("collisions: %d maps of %d queries, seed %u\n", mapCount, QUERIES_PER_MAP, seed);
+    for(int m = 0; m < mapCount; m++){
+        Map map = makeMap(rng);
+        // A third of the maps are for a point robot.
+        float radius = unit(rng) < 0.33f ? 0 : MAX_ROBOT_RADIUS * unit(rng);
+        std::vector<Query> queries = makeQueries(rng, map);
+        CollisionSetup setup(map, radius);
+
+        std::vector<char> expected(queries.size());
+        for(int backend = 0; backend < BACKEND_COUNT; backend++){
+            std::vector<char> answers(queries.size());
+            auto start = std::chrono::steady_clock::now();
+            for(size_t i = 0; i < queries.size(); i++){
+                answers[i] = setup.answer(backend, queries[i]);
+            }
+            seconds[backend] += secondsSince(start);
+            if(backend == REFERENCE){
+                expected = answers;
+                continue;
+            }
+            for(size_t i = 0; i < queries.size(); i++){
+                if(answers[i] == expected[i]){
+                    continue;
+                }
+                if(mismatches[backend]++ < REPRODUCERS_PER_BACKEND){
+                    Map small = map;
+                    Query q = queries[i];
+                    minimize(small, radius, backend, q);
+                    std::printf("map %d, query %zu:\n", m, i);
+                    printReproducer(small, radius, backend, q);
+                }
+            }
+        }
+        queryCount += queries.size();
+
+        if(m % PLAN_EVERY == 0){
+            using Kd = KdTreeNearest<2, float>;
+            using Linear = LinearNearest<2, float, Metric>;
+            std::pair<int, float> results[] = {
+                plan<Linear>(ObstacleCollision<2, float>(setup.triangles)),
+                plan<Kd>(ObstacleCollision<2, float>(setup.triangles)),
+                plan<Kd>(ObstacleCollision<2, float>(setup.convex)),
+                plan<Kd>(QuadTreeCollision<2, float>(setup.tree)),
+            };
+            plans++;
+            for(const std::pair<int, float>& result : results){
+                if(result != results[0]){
+                    planMismatches++;
+                    std::printf("map %d: the planner took %d iterations to cost %g with LinearNearest and"
+                                " the triangles, but %d iterations to cost %g with another backend\n",
+                                m, results[0].first, results[0].second, result.first, result.second);
+                    break;
+                }
+            }
+        }
+    }
+
+    std::printf("\n%-28s %12s %12s\n", "backend", "queries/s", "mismatches");
+    for(int backend = 0; backend < BACKEND_COUNT; backend++){
+        std::printf("%-28s %12.0f %12ld\n", BACKEND_NAMES[backend], queryCount / seconds[backend], mismatches[backend]);
+    }
+    std::printf("planner runs on %d maps with 4 backend pairs, %ld differed\n", plans, planMismatches);
+
+    std::printf("\nnearest neighbors: %d streams of %d operations\n", STREAM_COUNT, OPERATIONS_PER_STREAM);
+    long nearestMismatches = 0;
+    double linearSeconds = 0, treeSeconds = 0;
+    for(int s = 0; s < STREAM_COUNT; s++){
+        std::vector<Operation> ops = makeStream(rng);
+        linearSeconds += timeStream<LinearNearest<2, float, Metric>>(ops);
+        treeSeconds += timeStream<KdTreeNearest<2, float>>(ops);
+
+        std::string what;
+        int mismatch = firstMismatch(ops, &what);
+        if(mismatch < 0){
+            continue;
+        }
+        if(nearestMismatches++ < REPRODUCERS_PER_BACKEND){
+            std::vector<Operation> small = minimize(ops, mismatch);
+            std::printf("stream %d, operation %d: %s\n    shortest stream found, %zu operations:\n", s, mismatch, what.c_str(), small.size());
+            printStream(small);
+        }
+    }
+    double operations = double(STREAM_COUNT) * OPERATIONS_PER_STREAM;
+    std::printf("\n%-28s %12s %12s\n", "backend", "ops/s", "mismatches");
+    std::printf("%-28s %12.0f %12s\n", "LinearNearest (reference)", operations / linearSeconds, "-");
+    std::printf("%-28s %12.0f %12ld\n", "KdTreeNearest", operations / treeSeconds, nearestMismatches);
+
+    long total = planMismatches + nearestMismatches;
+    for(int backend = 0; backend < BACKEND_COUNT; backend++){
+        total += mismatches[backend];
+    }
+    std::printf("\n%s\n", total == 0 ? "All backends agree." : "Backends disagree, see above.");
+    return total == 0 ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+// Micro-benchmark of the geometry kernels in Math.cpp and Polygon.cpp, each in isolation.
+// Build with: python3 build.py kernel_bench
+// Run with:   ./kernel_bench [baseline] [--write] [--check-timing] [--tolerance fraction]
+//             (defaults to bench/kernel_baseline.json and a tolerance of 0.25)
+//
+// Every kernel runs over its own seeded workload, so the inputs, and therefore the sum of
+// its results, are the same on every run. The fastest of several passes gives ns/op and
+// throughput, and the allocations made during the passes are counted by replacing the
+// global operator new. Each kernel is checked against the baseline: a different result
+// sum means the kernel's answers changed and more allocations are a regression, either of
+// which exits with 1 on any machine.
+//
+// Timings only compare on the machine they were measured on, so by default they are only
+// reported. To gate on them, write a baseline with timings before changing a kernel and
+// check against it after, where ns/op more than the tolerance above the baseline fails:
+//     ./kernel_bench my_baseline.json --write --check-timing
+//     ./kernel_bench my_baseline.json --check-timing
+// The committed baseline holds no timings.
+//
+// The baseline is JSON, one kernel per line, read back line by line as --write lays it out.
+//
+// Vector2f has a user written copy constructor and assignment, so it is not trivially
+// copyable. g++ 12 at -O2 copies an array of it with a loop of one point at a time, keeping
+// the self assignment check, where an array of a plain pair of floats becomes a memmove;
+// other compilers may lower both to memmove. The copy kernels time one whole array copy of
+// each per operation and print the ratio.
+#include "Math.hpp"
+#include "Polygon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <numbers>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+size_t allocationCount = 0;
+
+} // namespace
+
+void* operator new(size_t size){
+    allocationCount++;
+    if(void* p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    std::free(p);
+}
+
+namespace {
+
+const int INPUT_COUNT = 1 << 16;   // Inputs in each kernel's workload.
+const int PASSES = 16;             // Passes over the inputs per timed sample.
+const int SAMPLES = 5;
+const int COPY_LENGTH = 1 << 16;   // Points per array in the copy kernels.
+const int COPY_COUNT = 64;         // Whole array copies per pass in the copy kernels.
+const float WORKSPACE_X = 640;
+const float WORKSPACE_Y = 480;
+const double RESULT_TOLERANCE = 1e-6;
+
+struct FloatPair{
+    float x, y;
+};
+
+static_assert(std::is_trivially_copyable_v<FloatPair>);
+
+struct Measurement{
+    double ns;          //< Fastest sample, per operation.
+    double result;      //< Sum of the kernel's results over one pass.
+    double allocations; //< Per operation.
+};
+
+struct Baseline{
+    double result;
+    double allocations;
+    double ns;          //< Negative if the baseline holds no timing.
+};
+
+double sink = 0;   // Results of the timed passes, kept so they are not optimized away.
+
+// Time kernel(i) for i below count, the sum of its results standing in for the answers.
+template <typename Kernel>
+Measurement measure(Kernel kernel, int count){
+    Measurement m{1e30, 0, 0};
+    for(int i = 0; i < count; i++){
+        m.result += kernel(i);
+    }
+
+    size_t allocationsBefore = allocationCount;
+    for(int sample = 0; sample < SAMPLES; sample++){
+        auto start = std::chrono::steady_clock::now();
+        for(int pass = 0; pass < PASSES; pass++){
+            for(int i = 0; i < count; i++){
+                sink += kernel(i);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        m.ns = std::min(m.ns, ns / (double(PASSES) * count));
+    }
+    m.allocations = double(allocationCount - allocationsBefore) / (double(SAMPLES) * PASSES * count);
+    return m;
+}
+
+std::map<std::string, Baseline> readBaseline(const std::string& filename){
+    std::map<std::string, Baseline> baseline;
+    FILE* file = std::fopen(filename.c_str(), "r");
+    if(file == nullptr){
+        return baseline;
+    }
+    char line[512];
+    while(std::fgets(line, sizeof(line), file) != nullptr){
+        char name[128];
+        Baseline b{0, 0, -1};
+        const char* entry = std::strstr(line, "{\"kernel\"");
+        if(entry != nullptr && std::sscanf(entry, "{\"kernel\": \"%127[^\"]\", \"result\": %lf, \"allocations_per_op\": %lf",
+                                           name, &b.result, &b.allocations) == 3){
+            const char* ns = std::strstr(entry, "\"ns_per_op\": ");
+            if(ns != nullptr){
+                std::sscanf(ns, "\"ns_per_op\": %lf", &b.ns);
+            }
+            baseline[name] = b;
+        }
+    }
+    std::fclose(file);
+    return baseline;
+}
+
+// Timings are only written when asked for, as they hold for this machine alone.
+bool writeBaseline(const std::string& filename, const std::vector<std::pair<std::string, Measurement>>& measured, bool timing){
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if(file == nullptr){
+        return false;
+    }
+    std::fprintf(file, "{\n  \"inputs\": %d,\n  \"kernels\": [\n", INPUT_COUNT);
+    for(size_t i = 0; i < measured.size(); i++){
+        const Measurement& m = measured[i].second;
+        char ns[64] = "";
+        if(timing){
+            std::snprintf(ns, sizeof(ns), ", \"ns_per_op\": %.3f", m.ns);
+        }
+        std::fprintf(file, "    {\"kernel\": \"%s\", \"result\": %.17g, \"allocations_per_op\": %.3f%s}%s\n",
+                     measured[i].first.c_str(), m.result, m.allocations, ns, i + 1 < measured.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+Vector2f randomPoint(std::mt19937& rng){
+    std::uniform_real_distribution<float> x(0, WORKSPACE_X), y(0, WORKSPACE_Y);
+    return {x(rng), y(rng)};
+}
+
+// A point up to reach away from p in each coordinate, so segments and triangles are about
+// the size of the planner's steps and the obstacles.
+Vector2f nearby(std::mt19937& rng, const Vector2f& p, float reach){
+    std::uniform_real_distribution<float> offset(-reach, reach);
+    return {p.x + offset(rng), p.y + offset(rng)};
+}
+
+// Star shaped polygon of n vertices around the workspace's center, one vertex per equal wedge.
+Polygon makePolygon(std::mt19937& rng, int n){
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::vector<Vertex> vertices;
+    for(int i = 0; i < n; i++){
+        float angle = 2 * std::numbers::pi_v<float> * (i + 0.8f * unit(rng)) / n;
+        float r = 200 * (0.4f + 0.6f * unit(rng));
+        vertices.push_back({0.5f * WORKSPACE_X + r * std::cos(angle), 0.5f * WORKSPACE_Y + r * std::sin(angle)});
+    }
+    Polygon polygon(vertices);
+    polygon.TriangulateMonotone();
+    return polygon;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    std::string baselineFile = "bench/kernel_baseline.json";
+    bool write = false;
+    bool checkTiming = false;
+    double tolerance = 0.25;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--write"){
+            write = true;
+        }else if(arg == "--check-timing"){
+            checkTiming = true;
+        }else if(arg == "--tolerance" && i + 1 < argc){
+            tolerance = std::atof(argv[++i]);
+        }else{
+            baselineFile = arg;
+        }
+    }
+
+    std::mt19937 rng(1);
+    std::vector<Vector2f> p(INPUT_COUNT), q(INPUT_COUNT), r(INPUT_COUNT), s(INPUT_COUNT);
+    std::vector<Triangle> triangles(INPUT_COUNT);
+    for(int i = 0; i < INPUT_COUNT; i++){
+        p[i] = randomPoint(rng);
+        q[i] = nearby(rng, p[i], 60);
+        r[i] = randomPoint(rng);
+        s[i] = nearby(rng, r[i], 60);
+        Vector2f a = randomPoint(rng);
+        Vector2f b = nearby(rng, a, 80);
+        Vector2f c = nearby(rng, a, 80);
+        triangles[i] = GetOrientation(a, b, c) == ORIENTATION::CLOCKWISE ? Triangle{a, c, b} : Triangle{a, b, c};
+    }
+    // Triangles hold p[i] about half of the time, and meet the segment from p[i] to q[i] more often.
+    for(int i = 0; i < INPUT_COUNT; i += 2){
+        p[i] = (triangles[i][0] + triangles[i][1] + triangles[i][2]) * (1.0f / 3);
+    }
+
+    Polygon triangulated = makePolygon(rng, 24);
+    Polygon decomposed = triangulated;
+    decomposed.DecomposeConvex();
+    std::vector<std::vector<Vector2f>> convex(INPUT_COUNT);
+    for(int i = 0; i < INPUT_COUNT; i++){
+        const std::vector<Vertex>& part = decomposed.convexParts[i % decomposed.convexParts.size()];
+        convex[i] = part;
+    }
+
+    std::vector<Vector2f> copySource(COPY_LENGTH), copyTarget(COPY_LENGTH);
+    std::vector<FloatPair> pairSource(COPY_LENGTH), pairTarget(COPY_LENGTH);
+    for(int i = 0; i < COPY_LENGTH; i++){
+        copySource[i] = randomPoint(rng);
+        pairSource[i] = {copySource[i].x, copySource[i].y};
+    }
+
+    std::map<std::string, Baseline> baseline = write ? std::map<std::string, Baseline>() : readBaseline(baselineFile);
+    if(!write && baseline.empty()){
+        std::printf("No baseline read from %s, only measuring. Write one with --write.\n\n", baselineFile.c_str());
+    }
+    std::printf("%d inputs per kernel, fastest of %d samples of %d passes. Vector2f is%s trivially copyable.\n\n",
+                INPUT_COUNT, SAMPLES, PASSES, std::is_trivially_copyable_v<Vector2f> ? "" : " not");
+    std::printf("%-40s %9s %10s %11s %11s  %s\n", "kernel", "ns/op", "Mops/s", "allocs/op", "baseline", "check");
+
+    std::vector<std::pair<std::string, Measurement>> measured;
+    int failures = 0;
+    auto run = [&](const std::string& name, auto kernel, int count = INPUT_COUNT){
+        Measurement m = measure(kernel, count);
+        measured.push_back({name, m});
+
+        std::string check = "-";
+        char baselineNs[32] = "-";
+        auto found = baseline.find(name);
+        if(found != baseline.end()){
+            const Baseline& b = found->second;
+            if(b.ns >= 0){
+                std::snprintf(baselineNs, sizeof(baselineNs), "%.2f", b.ns);
+            }
+            if(std::abs(m.result - b.result) > std::max(1.0, std::abs(b.result)) * RESULT_TOLERANCE){
+                check = "FAIL: results differ";
+            }else if(m.allocations > b.allocations){
+                check = "FAIL: allocates more";
+            }else if(checkTiming && b.ns >= 0 && m.ns > b.ns * (1 + tolerance)){
+                check = "FAIL: slower";
+            }else{
+                check = "ok";
+            }
+            failures += check != "ok";
+        }else if(!baseline.empty()){
+            check = "not in baseline";
+        }
+        std::printf("%-40s %9.2f %10.1f %11.3f %11s  %s\n", name.c_str(), m.ns, 1000 / m.ns, m.allocations, baselineNs, check.c_str());
+    };
+
+    run("Distance", [&](int i){ return Distance(p[i], r[i]); });
+    run("GetOrientation", [&](int i){ return double(GetOrientation(p[i], q[i], r[i])); });
+    run("PointInTriangle", [&](int i){ return double(PointInTriangle(p[i], triangles[i][0], triangles[i][1], triangles[i][2])); });
+    run("SegmentsIntersect", [&](int i){ return double(SegmentsIntersect(p[i], q[i], r[i], s[i])); });
+    run("SegmentInTriangle", [&](int i){ return double(SegmentInTriangle(p[i], q[i], triangles[i])); });
+    run("PointInConvexPolygon", [&](int i){ return double(PointInConvexPolygon(r[i], convex[i])); });
+    run("SegmentInConvexPolygon", [&](int i){ return double(SegmentInConvexPolygon(r[i], s[i], convex[i])); });
+    run("Polygon::contains (triangles)", [&](int i){ return double(triangulated.contains(r[i])); });
+    run("Polygon::contains (convex parts)", [&](int i){ return double(decomposed.contains(r[i])); });
+    run("Polygon::containsSegment (triangles)", [&](int i){ return double(triangulated.containsSegment(r[i], s[i])); });
+    run("Polygon::containsSegment (convex parts)", [&](int i){ return double(decomposed.containsSegment(r[i], s[i])); });
+    // One operation is one copy of the whole array.
+    run("copy Vector2f array", [&](int i){
+        std::copy(copySource.begin(), copySource.end(), copyTarget.begin());
+        return double(copyTarget[i].x);
+    }, COPY_COUNT);
+    run("copy float pair array", [&](int i){
+        std::copy(pairSource.begin(), pairSource.end(), pairTarget.begin());
+        return double(pairTarget[i].x);
+    }, COPY_COUNT);
+    double vectorCopy = measured[measured.size() - 2].second.ns;
+    double pairCopy = measured.back().second.ns;
+    std::printf("\n%d point copies: Vector2f %.3f ns per point, float pair %.3f ns per point, %.2fx\n",
+                COPY_LENGTH, vectorCopy / COPY_LENGTH, pairCopy / COPY_LENGTH, vectorCopy / pairCopy);
+
+    if(write){
+        if(!writeBaseline(baselineFile, measured, checkTiming)){
+            std::printf("\nUnable to write %s\n", baselineFile.c_str());
+            return 1;
+        }
+        std::printf("\nWrote %s\n", baselineFile.c_str());
+    }else if(!baseline.empty()){
+        std::printf("\n%d of %zu kernels failed against %s", failures, measured.size(), baselineFile.c_str());
+        if(checkTiming){
+            std::printf(", timings within %.0f%%", 100 * tolerance);
+        }
+        std::printf("\n");
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+// Benchmark of the path optimization stage.
+// Build with: python3 build.py path_bench
+// Run with:   ./path_bench [map file] [waypoints]   (defaults to every map, 5000 waypoints)
+//
+// A path from the planner only has a few dozen waypoints, so it is also split into the
+// given number of waypoints with each one nudged sideways, where that stays collision
+// free. That is the kind of path a finer planner or a raw trajectory produces, and the
+// one shortcutting has the most work to do on.
+#include "RRT.hpp"
+#include "PathOptimizer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Split each edge into pieces, moving each new waypoint up to jitter to the side.
+std::vector<Vector2f> densify(const Obstacles& obs, const std::vector<Vector2f>& path, size_t waypoints, float jitter){
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> side(-jitter, jitter);
+
+    float total = PathOptimizer::PathCost(path);
+    std::vector<Vector2f> dense = {path[0]};
+    for(size_t i = 1; i < path.size(); i++){
+        const Vector2f& a = path[i - 1];
+        const Vector2f& b = path[i];
+        size_t pieces = std::max<size_t>(1, size_t(waypoints * Distance(a, b) / total));
+        Vector2f normal(a.y - b.y, b.x - a.x);
+        normal.Normalize();
+        for(size_t k = 1; k < pieces; k++){
+            Vector2f on = a + (b - a) * (float(k) / pieces);
+            Vector2f moved = on + normal * side(rng);
+            bool free = !obs.inObstacles(moved) && !obs.segmentInObstacles(dense.back(), moved);
+            dense.push_back(free ? moved : on);
+        }
+        // Back onto the original edge's end, reachable from the last waypoint unless it was moved
+        // into a spot that only sees part of the edge.
+        if(obs.segmentInObstacles(dense.back(), b)){
+            dense.back() = a + (b - a) * (float(pieces - 1) / pieces);
+        }
+        dense.push_back(b);
+    }
+    return dense;
+}
+
+template <typename Stage>
+void time(const char* name, const std::vector<Vector2f>& in, Stage stage){
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Vector2f> out = stage(in);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("  %-22s %6zu -> %-6zu waypoints   cost %8.1f -> %8.1f   %8.3f ms\n", name, in.size(), out.size(),
+                PathOptimizer::PathCost(in), PathOptimizer::PathCost(out), ms);
+}
+
+void bench(const std::string& map, size_t waypoints){
+    Obstacles obs(map);
+    obs.decomposeConvex();
+
+    RRTStar planner(640, 480, obs, {10, 10}, {580, 460}, 20, 70, 30);
+    std::vector<Vector2f> path = planner.findBestPath();
+    if(path.size() < 2){
+        std::printf("%s: no path found\n", map.c_str());
+        return;
+    }
+
+    PathOptimizer optimizer(obs, 0, 1);
+    for(const std::vector<Vector2f>& in : {path, densify(obs, path, waypoints, 1.0f)}){
+        std::printf("%s, planner path%s\n", map.c_str(), in.size() > path.size() ? " densified" : "");
+        time("shortcutGreedy", in, [&](const std::vector<Vector2f>& p){ return optimizer.shortcutGreedy(p); });
+        time("shortcutRandom(200)", in, [&](const std::vector<Vector2f>& p){ return optimizer.shortcutRandom(p, 200); });
+        time("smooth", in, [&](const std::vector<Vector2f>& p){ return optimizer.smooth(p); });
+        time("optimize", in, [&](const std::vector<Vector2f>& p){ return optimizer.optimize(p); });
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    size_t waypoints = argc > 2 ? std::atoi(argv[2]) : 5000;
+    if(argc > 1){
+        bench(argv[1], waypoints);
+        return 0;
+    }
+    for(const char* map : {"small_obstacles.txt", "large_spread_out.txt", "unreachable_corner.txt"}){
+        bench(map, waypoints);
+    }
+    return 0;
+}
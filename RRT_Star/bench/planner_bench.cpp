@@ -0,0 +1,205 @@
+// Benchmark of full planner runs in each state space dimension.
+// Build with: python3 build.py planner_bench
+// Run with:   ./planner_bench [map file] [runs]   (defaults to small_obstacles.txt, 20 runs)
+//
+// The same polygon map is used for every planner: flat for 2D, extruded through the
+// height for 3D, and through height and heading for the 4D (x, y, z, heading) poses.
+// The 2D planner is also timed while streaming its tree deltas to a consumer thread,
+// as the viewer does, to show what publishing them costs the planner.
+//
+// Last, long searches that keep improving the path show how the cost of an iteration
+// grows with the tree under each neighborhood mode, with the linear scan and with the
+// kd-tree as the nearest neighbor index, and how many nodes the tree keeps with and
+// without pruning and a node budget. Then the path cost RRTStar and BITStar have reached
+// after the same planning time, and how many edges BIT* actually collision checked.
+#include "BITStar.hpp"
+#include "RRT.hpp"
+#include "SpscQueue.hpp"
+#include "TreeDeltas.hpp"
+
+#include <atomic>
+#include <thread>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <string>
+
+namespace {
+
+struct Result{
+    double msPerRun;
+    int found;
+    double meanCost;
+};
+
+template <typename Planner>
+Result run(Planner& planner, int runs){
+    Result r{0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < runs; i++){
+        if(!planner.findBestPath().empty()){
+            r.found++;
+            r.meanCost += planner.getCost();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    r.msPerRun = std::chrono::duration<double, std::milli>(end - start).count() / runs;
+    if(r.found > 0){
+        r.meanCost /= r.found;
+    }
+    return r;
+}
+
+void report(const char* name, const Result& r, int runs){
+    std::printf("%-24s %10.2f ms/run   found %3d/%-3d   mean cost %8.1f\n", name, r.msPerRun, r.found, runs, r.meanCost);
+}
+
+// Run a search of LONG_ITERATIONS iterations, timing each stretch between the checkpoints.
+const int LONG_ITERATIONS = 20000;
+const int CHECKPOINTS[] = {2500, 5000, 10000, 20000};
+
+template <typename Nearest>
+void growTree(const char* name, Obstacles& obs, NeighborhoodMode mode){
+    RRTStarN<2, float, EuclideanMetric<2, float>, Nearest> planner({0, 0}, {640, 480}, ObstacleCollision<2, float>(obs),
+                                                                   {10, 10}, {580, 460}, 20, 70, 30, LONG_ITERATIONS);
+    planner.setNeighborhoodMode(mode);
+    planner.beginSearch();
+    std::printf("%-28s", name);
+    int done = 0;
+    for(int checkpoint : CHECKPOINTS){
+        auto start = std::chrono::steady_clock::now();
+        planner.step(checkpoint - done);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::printf(" %8.1f", us / (checkpoint - done));
+        done = checkpoint;
+    }
+    std::printf("   cost %8.1f\n", planner.getCost());
+}
+
+void prunedTree(const char* name, Obstacles& obs, bool pruning, size_t budget){
+    RRTStar planner(640, 480, obs, {10, 10}, {580, 460}, 20, 70, 30, LONG_ITERATIONS);
+    planner.setPruning(pruning);
+    planner.setNodeBudget(budget);
+    auto start = std::chrono::steady_clock::now();
+    planner.beginSearch();
+    planner.step(LONG_ITERATIONS);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-28s %8.1f ms   nodes %6zu   slots %6zu   cost %8.1f\n", name, ms, planner.nodeCount(),
+                planner.slotCount(), planner.getCost());
+}
+
+// Keep searching past the first path, averaging the cost reached at each elapsed time.
+const int CONVERGENCE_RUNS = 5;
+const int CONVERGENCE_MS[] = {10, 25, 50, 100, 200};
+
+template <typename Planner, typename MakePlanner>
+void converge(const char* name, MakePlanner makePlanner){
+    const int n = std::size(CONVERGENCE_MS);
+    double cost[n] = {};
+    int found[n] = {};
+    long checked = 0;
+    for(int run = 0; run < CONVERGENCE_RUNS; run++){
+        Planner planner = makePlanner();
+        planner.beginSearch();
+        int elapsed = 0;
+        for(int i = 0; i < n; i++){
+            planner.runFor(std::chrono::milliseconds(CONVERGENCE_MS[i] - elapsed));
+            elapsed = CONVERGENCE_MS[i];
+            if(planner.hasPath()){
+                cost[i] += planner.getCost();
+                found[i]++;
+            }
+        }
+        if constexpr (requires { planner.edgesChecked(); }){
+            checked += planner.edgesChecked();
+        }
+    }
+    std::printf("%-28s", name);
+    for(int i = 0; i < n; i++){
+        if(found[i] > 0){
+            std::printf(" %6.1f %d/%d", cost[i] / found[i], found[i], CONVERGENCE_RUNS);
+        }else{
+            std::printf(" %6s %d/%d", "-", found[i], CONVERGENCE_RUNS);
+        }
+    }
+    if(checked > 0){
+        std::printf("   %ld edges checked", checked / CONVERGENCE_RUNS);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    std::string map = argc > 1 ? argv[1] : "small_obstacles.txt";
+    int runs = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    Obstacles obs(map);
+    obs.decomposeConvex();
+    std::printf("%s, %d runs each\n", map.c_str(), runs);
+
+    RRTStar planar(640, 480, obs, {10, 10}, {580, 460}, 20, 70, 30);
+    Result plain = run(planar, runs);
+    report("RRTStar (x, y)", plain, runs);
+
+    // Same runs with a thread replaying the deltas into a mirror, like the viewer's loop.
+    SpscQueue<TreeDelta<Vector2f>> deltas(1 << 16);
+    TreeDeltaLog<Vector2f> deltaLog(deltas);
+    std::atomic<bool> planning{true};
+    std::thread viewer([&](){
+        TreeMirror<Vector2f> mirror;
+        while(planning.load()){
+            mirror.drain(deltas);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    planar.setDeltaLog(&deltaLog);
+    Result streamed = run(planar, runs);
+    planning = false;
+    viewer.join();
+    planar.setDeltaLog(nullptr);
+    report("RRTStar streaming deltas", streamed, runs);
+    std::printf("%-24s %+9.1f%%\n", "  streaming overhead", 100.0 * (streamed.msPerRun / plain.msPerRun - 1));
+
+    RRTStar3f spatial({0, 0, 0}, {640, 480, 100}, ObstacleCollision<3, float>(obs),
+                      {10, 10, 0}, {580, 460, 50}, 20, 70, 30);
+    report("RRTStar3f (x, y, z)", run(spatial, runs), runs);
+
+    const float pi = std::numbers::pi_v<float>;
+    RRTStar4f posed({0, 0, 0, -pi}, {640, 480, 100, pi}, ObstacleCollision<4, float>(obs),
+                    {10, 10, 0, 0}, {580, 460, 50, pi / 2}, 30, 80, 30);
+    report("RRTStar4f (x, y, z, yaw)", run(posed, runs), runs);
+
+    std::printf("\nus/iteration up to iteration %27d %8d %8d %8d\n", CHECKPOINTS[0], CHECKPOINTS[1], CHECKPOINTS[2], CHECKPOINTS[3]);
+    using Linear = LinearNearest<2, float, EuclideanMetric<2, float>>;
+    using KdTree = KdTreeNearest<2, float>;
+    growTree<Linear>("fixed radius, linear", obs, NeighborhoodMode::FIXED_RADIUS);
+    growTree<KdTree>("fixed radius, kd-tree", obs, NeighborhoodMode::FIXED_RADIUS);
+    growTree<Linear>("shrinking radius, linear", obs, NeighborhoodMode::SHRINKING_RADIUS);
+    growTree<KdTree>("shrinking radius, kd-tree", obs, NeighborhoodMode::SHRINKING_RADIUS);
+    growTree<Linear>("k nearest, linear", obs, NeighborhoodMode::K_NEAREST);
+    growTree<KdTree>("k nearest, kd-tree", obs, NeighborhoodMode::K_NEAREST);
+
+    std::printf("\n%d iterations, shrinking radius, kd-tree\n", LONG_ITERATIONS);
+    prunedTree("no pruning", obs, false, 0);
+    prunedTree("pruning", obs, true, 0);
+    prunedTree("pruning, budget 2000", obs, true, 2000);
+
+    std::printf("\n%-28s", "mean cost, found after ms");
+    for(int ms : CONVERGENCE_MS){
+        std::printf(" %10d", ms);
+    }
+    std::printf("\n");
+    converge<RRTStar>("RRTStar", [&](){
+        return RRTStar(640, 480, obs, {10, 10}, {580, 460}, 20, 70, 30, std::numeric_limits<int>::max());
+    });
+    converge<BITStar>("BITStar, 100 per batch", [&](){
+        return BITStar(640, 480, obs, {10, 10}, {580, 460}, 20, 100, std::numeric_limits<int>::max());
+    });
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Benchmark of the exact orientation predicate against plain float arithmetic.
+// Build with: python3 build.py predicate_bench
+// Run with:   ./predicate_bench
+//
+// Two seeded sets of point triples are timed: uniform points over the workspace, where
+// the float filter settles every sign, and points rounded onto a common line, where it
+// has to fall back to exact arithmetic. Wrong signs are counted against Orient2DExact.
+#include "Math.hpp"
+#include "Predicates.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int TRIPLE_COUNT = 1000000;
+const int REPEATS = 5;
+const float WORKSPACE_X = 640;
+const float WORKSPACE_Y = 480;
+
+struct Triple{
+    Vector2f a, b, c;
+};
+
+std::vector<Triple> uniformTriples(unsigned seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> x(0, WORKSPACE_X), y(0, WORKSPACE_Y);
+    std::vector<Triple> triples;
+    for(int i = 0; i < TRIPLE_COUNT; i++){
+        triples.push_back({{x(rng), y(rng)}, {x(rng), y(rng)}, {x(rng), y(rng)}});
+    }
+    return triples;
+}
+
+// c is placed on the line through a and b, then rounded to float, so it lands a
+// fraction of an ulp to either side or exactly on the line.
+std::vector<Triple> nearlyCollinearTriples(unsigned seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> x(0, WORKSPACE_X), y(0, WORKSPACE_Y), t(-1, 2);
+    std::vector<Triple> triples;
+    for(int i = 0; i < TRIPLE_COUNT; i++){
+        Vector2f a{x(rng), y(rng)};
+        Vector2f b{x(rng), y(rng)};
+        double along = t(rng);
+        Vector2f c{(float)(a.x + along * ((double)b.x - a.x)), (float)(a.y + along * ((double)b.y - a.y))};
+        triples.push_back({a, b, c});
+    }
+    return triples;
+}
+
+int Sign(double value){
+    return (value > 0) - (value < 0);
+}
+
+int FloatOrient(const Vector2f& a, const Vector2f& b, const Vector2f& c){
+    return Sign((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+}
+
+int DoubleOrient(const Vector2f& a, const Vector2f& b, const Vector2f& c){
+    return Sign(((double)b.x - a.x) * ((double)c.y - a.y) - ((double)b.y - a.y) * ((double)c.x - a.x));
+}
+
+// isLeft before the exact predicates, truncating the determinant to int.
+int TruncatedOrient(const Vector2f& a, const Vector2f& b, const Vector2f& c){
+    return Sign((int)((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)));
+}
+
+struct Result{
+    double ns;
+    int wrong;
+};
+
+// Fastest of several passes, counting signs that disagree with the exact ones.
+template <typename Orient>
+Result time(const std::vector<Triple>& triples, const std::vector<int>& exact, Orient orient){
+    Result r{1e30, 0};
+    for(int repeat = 0; repeat < REPEATS; repeat++){
+        int wrong = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < triples.size(); i++){
+            wrong += orient(triples[i].a, triples[i].b, triples[i].c) != exact[i];
+        }
+        auto end = std::chrono::steady_clock::now();
+        r.ns = std::min(r.ns, std::chrono::duration<double, std::nano>(end - start).count() / triples.size());
+        r.wrong = wrong;
+    }
+    return r;
+}
+
+void report(const char* set, const std::vector<Triple>& triples){
+    std::vector<int> exact;
+    int fallbacks = 0;
+    for(const Triple& t : triples){
+        exact.push_back(Orient2DExact(t.a, t.b, t.c));
+        fallbacks += Orient2DFloatFilter(t.a, t.b, t.c) == 0;
+    }
+
+    Result naive = time(triples, exact, FloatOrient);
+    Result truncated = time(triples, exact, TruncatedOrient);
+    Result precise = time(triples, exact, DoubleOrient);
+    Result filtered = time(triples, exact, Orient2D);
+    Result exactOnly = time(triples, exact, Orient2DExact);
+
+    std::printf("%s, exact fallback on %.2f%% of triples\n", set, 100.0 * fallbacks / triples.size());
+    std::printf("  %-22s %8s %12s\n", "predicate", "ns/op", "wrong signs");
+    std::printf("  %-22s %8.2f %12d\n", "float", naive.ns, naive.wrong);
+    std::printf("  %-22s %8.2f %12d\n", "float truncated to int", truncated.ns, truncated.wrong);
+    std::printf("  %-22s %8.2f %12d\n", "double", precise.ns, precise.wrong);
+    std::printf("  %-22s %8.2f %12d   (%.2fx float)\n", "Orient2D (filtered)", filtered.ns, filtered.wrong, filtered.ns / naive.ns);
+    std::printf("  %-22s %8.2f %12d\n", "Orient2DExact", exactOnly.ns, exactOnly.wrong);
+}
+
+} // namespace
+
+int main(){
+    report("uniform", uniformTriples(1));
+    report("nearly collinear", nearlyCollinearTriples(2));
+    return 0;
+}
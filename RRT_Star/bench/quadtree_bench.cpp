@@ -0,0 +1,158 @@
+// Benchmark of the occupancy quadtree on a huge, sparse workspace.
+// Build with: python3 build.py quadtree_bench
+// Run with:   ./quadtree_bench [side] [polygons]   (defaults to a 200000 x 200000 workspace, 500 polygons)
+//
+// A seeded map of scattered star shaped polygons is generated, and the quadtree is built at
+// several minimum cell sizes. For each, the tree's size is reported next to a one byte per
+// cell raster at the same resolution, and the same seeded points, segments and disc motions
+// are answered exactly and through the tree, counting the fraction the leaves settle and
+// any answer that differs, which should never happen. Last, the planner runs across the
+// map with each collision backend.
+#include "RRT.hpp"
+#include "QuadTree.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int QUERY_COUNT = 200000;
+const float ROBOT_RADIUS = 50;
+const int PLAN_ITERATIONS = 20000;
+const float MIN_CELL_SIZES[] = {1024, 256, 64, 16};
+
+// Star shaped polygons, a vertex in each of n equal wedges around the center, of 3 to 12
+// vertices up to 3000 units across, kept clear of the corners the planner runs between.
+Obstacles makeMap(float side, int polygons, unsigned seed, double& boundaryLength){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(0, side);
+    std::uniform_real_distribution<float> size(200, 3000);
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::uniform_int_distribution<int> vertexCount(3, 12);
+
+    std::vector<float> xy;
+    std::vector<uint32_t> counts;
+    boundaryLength = 0;
+    while(int(counts.size()) < polygons){
+        Vector2f center(position(rng), position(rng));
+        float radius = size(rng);
+        if(Distance(center, {0, 0}) < radius + 0.05f * side || Distance(center, {side, side}) < radius + 0.05f * side){
+            continue;
+        }
+        int n = vertexCount(rng);
+        std::vector<Vector2f> vertices;
+        for(int i = 0; i < n; i++){
+            float angle = 2 * std::numbers::pi_v<float> * (i + 0.8f * unit(rng)) / n;
+            float r = radius * (0.5f + 0.5f * unit(rng));
+            vertices.push_back({center.x + r * std::cos(angle), center.y + r * std::sin(angle)});
+        }
+        for(int i = 0; i < n; i++){
+            xy.push_back(vertices[i].x);
+            xy.push_back(vertices[i].y);
+            boundaryLength += Distance(vertices[i], vertices[(i + 1) % n]);
+        }
+        counts.push_back(n);
+    }
+    return Obstacles(xy.data(), counts.data(), counts.size());
+}
+
+double nanosecondsSince(std::chrono::steady_clock::time_point start, int count){
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Time exact(i) and tree(i) over every query, counting the queries the leaves settle and the
+// answers that differ.
+template <typename Exact, typename Tree, typename Settled>
+void compare(const char* name, Exact exact, Tree tree, Settled settled){
+    std::vector<char> expected(QUERY_COUNT);
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < QUERY_COUNT; i++){
+        expected[i] = exact(i);
+    }
+    double exactNs = nanosecondsSince(start, QUERY_COUNT);
+
+    int wrong = 0;
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < QUERY_COUNT; i++){
+        wrong += tree(i) != expected[i];
+    }
+    double treeNs = nanosecondsSince(start, QUERY_COUNT);
+
+    int count = 0;
+    for(int i = 0; i < QUERY_COUNT; i++){
+        count += settled(i);
+    }
+    std::printf("  %-9s exact %7.1f ns   tree %7.1f ns   settled by leaves %5.1f%%   wrong %d\n",
+                name, exactNs, treeNs, 100.0 * count / QUERY_COUNT, wrong);
+}
+
+template <typename Collision>
+void plan(const char* name, float side, Collision collision){
+    RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>, Collision> planner(
+        {0, 0}, {side, side}, collision, {0.01f * side, 0.01f * side}, {0.99f * side, 0.99f * side},
+        0.01f * side, 0.1f * side, 0.025f * side, PLAN_ITERATIONS);
+    planner.setSeed(1);
+    auto start = std::chrono::steady_clock::now();
+    planner.findBestPath();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-28s %8.1f ms   iterations %5d   cost %10.1f\n", name, ms, planner.iterations(), planner.getCost());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    float side = argc > 1 ? std::atof(argv[1]) : 200000;
+    int polygons = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    double boundaryLength;
+    auto start = std::chrono::steady_clock::now();
+    Obstacles obs = makeMap(side, polygons, 7, boundaryLength);
+    obs.decomposeConvex();
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%g x %g workspace, %d polygons, boundary length %.0f, built in %.1f ms\n\n",
+                side, side, polygons, boundaryLength, loadMs);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(0, side);
+    std::uniform_real_distribution<float> offset(-0.025f * side, 0.025f * side);
+    std::vector<Vector2f> points, starts, ends;
+    for(int i = 0; i < QUERY_COUNT; i++){
+        points.push_back({coordinate(rng), coordinate(rng)});
+        Vector2f a(coordinate(rng), coordinate(rng));
+        starts.push_back(a);
+        ends.push_back({std::clamp(a.x + offset(rng), 0.0f, side), std::clamp(a.y + offset(rng), 0.0f, side)});
+    }
+
+    for(float minCell : MIN_CELL_SIZES){
+        start = std::chrono::steady_clock::now();
+        OccupancyQuadTree tree(obs, {0, 0}, {side, side}, minCell);
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double rasterBytes = double(side / minCell) * double(side / minCell);
+        std::printf("min cell %g: built in %.1f ms, %zu nodes (%zu free, %zu full, %zu mixed leaves), %.1f KB,"
+                    " %.1f bytes per unit of boundary, raster %.1f MB\n",
+                    minCell, buildMs, tree.nodeCount(), tree.leafCount(Occupancy::FREE), tree.leafCount(Occupancy::FULL),
+                    tree.leafCount(Occupancy::MIXED), tree.memoryBytes() / 1024.0, tree.memoryBytes() / boundaryLength,
+                    rasterBytes / (1024.0 * 1024.0));
+
+        compare("points", [&](int i){ return obs.inObstacles(points[i]); },
+                [&](int i){ return tree.inObstacles(points[i]); },
+                [&](int i){ return tree.occupancy(points[i]) != Occupancy::MIXED; });
+        compare("segments", [&](int i){ return obs.segmentInObstacles(starts[i], ends[i]); },
+                [&](int i){ return tree.segmentInObstacles(starts[i], ends[i]); },
+                [&](int i){ return tree.occupancy(starts[i], ends[i]) != Occupancy::MIXED; });
+        compare("discs", [&](int i){ return obs.segmentInObstacles(starts[i], ends[i], ROBOT_RADIUS); },
+                [&](int i){ return tree.segmentInObstacles(starts[i], ends[i], ROBOT_RADIUS); },
+                [&](int i){ return tree.occupancy(starts[i], ends[i], ROBOT_RADIUS) != Occupancy::MIXED; });
+    }
+
+    std::printf("\nplanning across the workspace, up to %d iterations\n", PLAN_ITERATIONS);
+    OccupancyQuadTree tree(obs, {0, 0}, {side, side}, 64);
+    plan("ObstacleCollision", side, ObstacleCollision<2, float>(obs));
+    plan("QuadTreeCollision", side, QuadTreeCollision<2, float>(tree));
+    return 0;
+}
@@ -1,5 +1,7 @@
 # Run with: python3 build.py
 import os
+import sys
+import glob
 import platform
 
 # (1)==================== COMMON CONFIGURATION OPTIONS ======================= #
@@ -9,6 +11,27 @@ SOURCE="./src/*.cpp"     # Where the source code lives
 EXECUTABLE="prog"        # Name of the final executable
 # ======================= COMMON CONFIGURATION OPTIONS ======================= #
 
+# (1.5)======================== Benchmark targets ============================== #
+# Run with: python3 build.py <target>
+# Benchmarks are built optimized and headless (-D HEADLESS), so they need no SDL.
+BENCHMARKS={"collision_bench": "./bench/collision_bench.cpp",
+            "planner_bench": "./bench/planner_bench.cpp",
+            "predicate_bench": "./bench/predicate_bench.cpp",
+            "path_bench": "./bench/path_bench.cpp",
+            "clearance_bench": "./bench/clearance_bench.cpp",
+            "quadtree_bench": "./bench/quadtree_bench.cpp",
+            "kernel_bench": "./bench/kernel_bench.cpp",
+            "differential_check": "./bench/differential_check.cpp"}
+# The planning daemon and its load generator build the same way. They use Unix
+# sockets, so are only available on Linux and Mac.
+BENCHMARKS.update({"plannerd": "./daemon/plannerd.cpp",
+                   "plan_load": "./daemon/plan_load.cpp"})
+TARGET=sys.argv[1] if len(sys.argv) > 1 else None
+if TARGET is not None and TARGET not in BENCHMARKS:
+    print("Unknown target '"+TARGET+"', expected one of: "+", ".join(BENCHMARKS))
+    exit(1)
+# (1.5)======================== Benchmark targets ============================== #
+
 # (2)=================== Platform specific configuration ===================== #
 # For each platform we need to set the following items
 ARGUMENTS=""            # Arguments needed for our program (Add others as you see fit)
@@ -17,20 +40,28 @@ LIBRARIES=""            # What libraries do we want to include
 
 if platform.system()=="Linux":
     ARGUMENTS="-D LINUX" # -D is a #define sent to preprocessor
-    INCLUDE_DIR="-I ./../common/include/"
-    LIBRARIES="-lSDL2 -ldl"
+    INCLUDE_DIR="-I ./include/"
+    LIBRARIES="-lSDL2 -ldl -pthread"
 elif platform.system()=="Darwin":
     ARGUMENTS="-D MAC" # -D is a #define sent to the preprocessor.
-    INCLUDE_DIR="-I ./../common/include/ -I/Library/Frameworks/SDL2.framework/Headers"
+    INCLUDE_DIR="-I ./include/ -I/Library/Frameworks/SDL2.framework/Headers"
     LIBRARIES="-F/Library/Frameworks -framework SDL2"
 elif platform.system()=="Windows":
-    COMPILER="g++ -std=c++17" # Note we use g++ here as it is more likely what you have
+    COMPILER="g++ -std=c++20" # Note we use g++ here as it is more likely what you have
     ARGUMENTS="-D MINGW -static-libgcc -static-libstdc++" 
     INCLUDE_DIR="-I./include/"
     EXECUTABLE="prog.exe"
     LIBRARIES="-lmingw32 -lSDL2main -lSDL2"
 # (2)=================== Platform specific configuration ===================== #
 
+# Swap the program's entry point for the benchmark's and drop SDL.
+if TARGET is not None:
+    SOURCE=BENCHMARKS[TARGET]+" "+" ".join(f for f in sorted(glob.glob("./src/*.cpp")) if not f.endswith("main.cpp"))
+    COMPILER=COMPILER+" -O2"
+    ARGUMENTS=ARGUMENTS+" -D HEADLESS"
+    EXECUTABLE=TARGET+(".exe" if platform.system()=="Windows" else "")
+    LIBRARIES="" if platform.system()=="Windows" else "-pthread"
+
 # (3)====================== Building the Executable ========================== #
 # Build a string of our compile commands that we run in the terminal
 compileString=COMPILER+" "+ARGUMENTS+" "+SOURCE+" -o "+EXECUTABLE+" "+" "+INCLUDE_DIR+" "+LIBRARIES
@@ -0,0 +1,134 @@
+#ifndef PLAN_PROTOCOL_HPP
+#define PLAN_PROTOCOL_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Wire format spoken by plannerd and its clients over a Unix stream socket, in the host's
+// byte order since both ends are on the same machine. Every message is a Header followed by
+// header.size bytes of payload:
+//
+//   PLAN       client -> server   PlanRequest
+//   RESULT     server -> client   PlanResult, then pointCount * (x, y) floats from the goal
+//                                 back to the start, the order of bestPath()
+//   ERROR      server -> client   the message text, not terminated
+//   LIST_MAPS  client -> server   no payload
+//   MAPS       server -> client   the resident map names, each followed by '\n'
+//
+// A client may send any number of requests without waiting. The server answers each one
+// with the same requestId, in whatever order they finish.
+namespace PlanProtocol{
+
+const uint32_t MAGIC = 0x50545252; //< "RRTP" read as little endian.
+const uint16_t VERSION = 1;
+const uint32_t MAX_PAYLOAD = 1 << 20;
+const size_t MAP_NAME_SIZE = 32;
+
+enum class MessageType : uint16_t{
+    PLAN = 1,
+    RESULT = 2,
+    ERROR = 3,
+    LIST_MAPS = 4,
+    MAPS = 5
+};
+
+enum class PlannerKind : uint8_t{
+    RRT_STAR = 0,
+    BIT_STAR = 1
+};
+
+struct Header{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    uint32_t requestId;
+    uint32_t size;      //< Bytes of payload following the header.
+};
+
+struct PlanRequest{
+    char map[MAP_NAME_SIZE];  //< Resident map to plan on, zero padded.
+    uint8_t planner;          //< PlannerKind.
+    uint8_t stopAtFirstPath;  //< Nonzero to stop at the first path rather than keep shortening it.
+    uint16_t reserved;
+    float startX;
+    float startY;
+    float goalX;
+    float goalY;
+    float goalRadius;
+    float robotRadius;        //< 0 for a point robot, otherwise a disc checked with the map's distance field.
+    uint32_t iterations;      //< Iterations to run for, RRTStar's maximum or BITStar's steps.
+    uint32_t timeLimitMs;     //< Stop earlier once this much time has passed, 0 for no limit.
+};
+
+struct PlanResult{
+    uint8_t status;           //< PlanStatus the planner stopped with.
+    uint8_t found;            //< Nonzero if a path was found.
+    uint16_t reserved;
+    float cost;
+    uint32_t microseconds;    //< Time spent planning, not counting the queue or the socket.
+    uint32_t pointCount;
+};
+
+/// @brief Fill a Header for a message of the given type and payload size.
+inline Header MakeHeader(MessageType type, uint32_t requestId, uint32_t size){
+    return {MAGIC, VERSION, static_cast<uint16_t>(type), requestId, size};
+}
+
+/// @brief Read exactly size bytes, retrying short reads.
+/// @return False if the peer closed the socket or it failed first.
+inline bool ReadFully(int fd, void* data, size_t size){
+    char* p = static_cast<char*>(data);
+    while(size > 0){
+        ssize_t n = read(fd, p, size);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+/// @brief Write exactly size bytes, retrying short writes.
+/// @return False if the socket failed first.
+inline bool WriteFully(int fd, const void* data, size_t size){
+    const char* p = static_cast<const char*>(data);
+    while(size > 0){
+        ssize_t n = write(fd, p, size);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+/// @brief Fill in the address of the socket at path.
+/// @return False if the path does not fit in a socket address.
+inline bool SocketAddress(const std::string& path, sockaddr_un& address){
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)){
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+} // namespace PlanProtocol
+
+#endif
@@ -0,0 +1,159 @@
+// Load generator for plannerd: each connection sends plan requests one after another,
+// timing each from sending it to reading the reply, and the latencies are reported at the end.
+// Build with: python3 build.py plan_load
+// Run with:   ./plan_load <socket path> <map name> [requests] [connections] [rrt|bit] [iterations]
+//             (defaults to 1000 requests over 4 connections with RRTStar, 3000 iterations)
+//
+// Requests plan for the viewer's default start, goal and point robot, stopping at the
+// first path. The server's own planning time comes back in every reply, so the report
+// separates the time spent planning from the time spent queueing and on the socket.
+#include "PlanProtocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace PlanProtocol;
+
+namespace {
+
+struct Latencies{
+    std::vector<double> total;     //< Microseconds from sending a request to reading its reply.
+    std::vector<double> planning;  //< Microseconds the server reported planning for.
+    int found = 0;
+    int errors = 0;
+};
+
+// Send count requests over a new connection, one at a time.
+bool runConnection(const std::string& socketPath, const PlanRequest& request, int count, uint32_t firstId, Latencies& out){
+    sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || !SocketAddress(socketPath, address) || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0){
+        std::perror("Unable to connect");
+        if(fd >= 0){
+            close(fd);
+        }
+        return false;
+    }
+
+    std::string message(sizeof(Header) + sizeof(PlanRequest), '\0');
+    std::memcpy(message.data() + sizeof(Header), &request, sizeof(request));
+    std::string payload;
+    bool ok = true;
+    for(int i = 0; i < count && ok; i++){
+        Header header = MakeHeader(MessageType::PLAN, firstId + i, sizeof(PlanRequest));
+        std::memcpy(message.data(), &header, sizeof(header));
+
+        auto start = std::chrono::steady_clock::now();
+        ok = WriteFully(fd, message.data(), message.size()) && ReadFully(fd, &header, sizeof(header))
+             && header.magic == MAGIC && header.size <= MAX_PAYLOAD;
+        if(ok){
+            payload.resize(header.size);
+            ok = ReadFully(fd, payload.data(), payload.size());
+        }
+        if(!ok){
+            std::fprintf(stderr, "Connection to the daemon lost.\n");
+            break;
+        }
+        out.total.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+        if(static_cast<MessageType>(header.type) == MessageType::RESULT && payload.size() >= sizeof(PlanResult)){
+            PlanResult result;
+            std::memcpy(&result, payload.data(), sizeof(result));
+            out.planning.push_back(result.microseconds);
+            out.found += result.found != 0;
+        }else{
+            if(out.errors++ == 0 && static_cast<MessageType>(header.type) == MessageType::ERROR){
+                std::fprintf(stderr, "Daemon error: %s\n", payload.c_str());
+            }
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+double percentile(std::vector<double>& values, double fraction){
+    if(values.empty()){
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, size_t(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void report(const char* name, std::vector<double>& values){
+    std::printf("%-24s p50 %9.1f us   p90 %9.1f us   p99 %9.1f us   max %9.1f us\n", name,
+                percentile(values, 0.5), percentile(values, 0.9), percentile(values, 0.99), percentile(values, 1.0));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::printf("e.g. ./plan_load <socket path> <map name> [requests] [connections] [rrt|bit] [iterations]\n");
+        return 1;
+    }
+    std::string socketPath = argv[1];
+    std::string map = argv[2];
+    int requests = argc > 3 ? std::atoi(argv[3]) : 1000;
+    int connections = std::max(1, argc > 4 ? std::atoi(argv[4]) : 4);
+    std::string planner = argc > 5 ? argv[5] : "rrt";
+    int iterations = argc > 6 ? std::atoi(argv[6]) : 3000;
+    if(map.size() >= MAP_NAME_SIZE || (planner != "rrt" && planner != "bit")){
+        std::printf("Map names are under %zu characters and the planner is rrt or bit.\n", MAP_NAME_SIZE);
+        return 1;
+    }
+
+    PlanRequest request{};
+    std::memcpy(request.map, map.data(), map.size());
+    request.planner = static_cast<uint8_t>(planner == "bit" ? PlannerKind::BIT_STAR : PlannerKind::RRT_STAR);
+    request.stopAtFirstPath = 1;
+    request.startX = 10;
+    request.startY = 10;
+    request.goalX = 580;
+    request.goalY = 460;
+    request.goalRadius = 20;
+    request.robotRadius = 0;
+    request.iterations = iterations;
+    request.timeLimitMs = 0;
+
+    std::vector<Latencies> results(connections);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+    auto start = std::chrono::steady_clock::now();
+    for(int c = 0; c < connections; c++){
+        int count = requests / connections + (c < requests % connections ? 1 : 0);
+        threads.emplace_back([&, c, count](){
+            if(!runConnection(socketPath, request, count, uint32_t(c) << 24, results[c])){
+                failed = true;
+            }
+        });
+    }
+    for(std::thread& thread : threads){
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Latencies all;
+    for(const Latencies& r : results){
+        all.total.insert(all.total.end(), r.total.begin(), r.total.end());
+        all.planning.insert(all.planning.end(), r.planning.begin(), r.planning.end());
+        all.found += r.found;
+        all.errors += r.errors;
+    }
+    std::printf("%zu requests over %d connections in %.2f s, %.1f requests/s, found %d, errors %d\n",
+                all.total.size(), connections, seconds, all.total.size() / seconds, all.found, all.errors);
+    report("round trip", all.total);
+    report("planning (server side)", all.planning);
+    return failed ? 1 : 0;
+}
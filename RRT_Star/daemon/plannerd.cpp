@@ -0,0 +1,408 @@
+// Planning daemon: keeps maps loaded, decomposed and indexed, and answers plan requests
+// from other processes over a Unix socket, so a query pays for neither process startup
+// nor parsing and triangulating the obstacle file.
+// Build with: python3 build.py plannerd
+// Run with:   ./plannerd <socket path> <name>=<map file>[@<width>x<height>]... [-j workers]
+//             e.g. ./plannerd /tmp/plannerd.sock small=small_obstacles.txt large=large_spread_out.txt@640x480
+//
+// Each map's workspace defaults to the viewer's 640x480. Every connection gets a thread
+// reading its requests, which hands them to a fixed pool of workers (one per core unless
+// -j says otherwise) to plan and reply. See PlanProtocol.hpp for the messages. SIGINT or
+// SIGTERM cancels the searches in progress and shuts the daemon down.
+#include "PlanProtocol.hpp"
+#include "BITStar.hpp"
+#include "DistanceField.hpp"
+#include "RRT.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace PlanProtocol;
+
+namespace {
+
+// Iterations run between checks of the request's time limit.
+const int STEP_CHUNK = 256;
+// Requests waiting for a worker before the connections stop reading more.
+const size_t MAX_QUEUED = 1024;
+
+using BITStarDisc = BITStarN<2, float, KdTreeNearest<2, float>, ClearanceCollision<2, float>>;
+
+/// A map held in memory between requests, with everything the planners need built once.
+/// Only read after loading, so any number of workers may plan on it at once.
+struct ResidentMap{
+    ResidentMap(const std::string& file, float width, float height)
+        : obstacles(load(file)), field(obstacles, width, height), upper(width, height){
+    }
+
+    Obstacles obstacles;
+    DistanceField field;
+    Vector2f upper;
+
+    static Obstacles load(const std::string& file){
+        Obstacles obs(file);
+        obs.decomposeConvex();
+        return obs;
+    }
+};
+
+/// One client's socket. Workers finishing its requests take turns writing to it.
+struct Connection{
+    explicit Connection(int fd) : fd(fd){
+    }
+
+    ~Connection(){
+        close(fd);
+    }
+
+    bool send(MessageType type, uint32_t requestId, const std::string& payload){
+        Header header = MakeHeader(type, requestId, payload.size());
+        std::string message(reinterpret_cast<const char*>(&header), sizeof(header));
+        message += payload;
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return WriteFully(fd, message.data(), message.size());
+    }
+
+    int fd;
+    std::mutex writeMutex;
+};
+
+// Thread reading one connection's requests.
+struct Reader{
+    std::thread thread;
+    std::weak_ptr<Connection> connection;
+    std::shared_ptr<std::atomic<bool>> finished;
+};
+
+struct Job{
+    std::shared_ptr<Connection> connection;
+    uint32_t requestId;
+    PlanRequest request;
+};
+
+/// @brief Fixed set of threads running jobs in the order they were submitted.
+class WorkerPool{
+public:
+    using Handler = std::function<void(const Job&, std::stop_token)>;
+
+    WorkerPool(int workers, Handler handler) : m_handler(std::move(handler)){
+        for(int i = 0; i < workers; i++){
+            m_workers.emplace_back([this](std::stop_token stop){ work(stop); });
+        }
+    }
+
+    /// @brief Queue a job, waiting while MAX_QUEUED jobs are already waiting.
+    /// @return False if the pool is stopping.
+    bool submit(Job job){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [&](){ return m_stopping || m_jobs.size() < MAX_QUEUED; });
+        if(m_stopping){
+            return false;
+        }
+        m_jobs.push_back(std::move(job));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    /// @brief Drop the waiting jobs, cancel the running ones and join the workers.
+    void stop(){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_jobs.clear();
+        }
+        for(std::jthread& worker : m_workers){
+            worker.request_stop();
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+        m_workers.clear();
+    }
+
+private:
+    Handler m_handler;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Job> m_jobs;
+    bool m_stopping = false;
+    std::vector<std::jthread> m_workers;
+
+    void work(std::stop_token stop){
+        while(true){
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notEmpty.wait(lock, [&](){ return m_stopping || !m_jobs.empty(); });
+                if(m_stopping){
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                m_notFull.notify_one();
+            }
+            m_handler(job, stop);
+        }
+    }
+};
+
+// Run the search the request asks for and append its result to reply.
+template <typename Planner>
+void plan(Planner& planner, const PlanRequest& request, std::stop_token stop, std::string& reply){
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(request.timeLimitMs);
+    planner.beginSearch(request.stopAtFirstPath != 0);
+    PlanStatus status = PlanStatus::RUNNING;
+    uint32_t done = 0;
+    while(status == PlanStatus::RUNNING && done < request.iterations){
+        int n = std::min<uint32_t>(STEP_CHUNK, request.iterations - done);
+        status = planner.step(n, stop);
+        done += n;
+        if(request.timeLimitMs > 0 && std::chrono::steady_clock::now() >= deadline){
+            break;
+        }
+    }
+
+    const auto& path = planner.bestPath();
+    PlanResult result{};
+    result.status = static_cast<uint8_t>(status);
+    result.found = planner.hasPath();
+    result.cost = planner.getCost();
+    result.microseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    result.pointCount = path.size();
+    reply.append(reinterpret_cast<const char*>(&result), sizeof(result));
+    for(const Vector2f& p : path){
+        reply.append(reinterpret_cast<const char*>(&p.x), sizeof(float));
+        reply.append(reinterpret_cast<const char*>(&p.y), sizeof(float));
+    }
+}
+
+void handle(const std::map<std::string, std::unique_ptr<ResidentMap>>& maps, const Job& job, std::stop_token stop){
+    const PlanRequest& request = job.request;
+    std::string name(request.map, strnlen(request.map, MAP_NAME_SIZE));
+    auto found = maps.find(name);
+    if(found == maps.end()){
+        job.connection->send(MessageType::ERROR, job.requestId, "Unknown map '" + name + "'.");
+        return;
+    }
+    const ResidentMap& map = *found->second;
+
+    Vector2f lower(0, 0);
+    Vector2f start(request.startX, request.startY);
+    Vector2f goal(request.goalX, request.goalY);
+    int iterations = std::min<uint32_t>(request.iterations, std::numeric_limits<int>::max());
+    std::string reply;
+    try{
+        bool disc = request.robotRadius > 0;
+        if(request.planner == static_cast<uint8_t>(PlannerKind::BIT_STAR)){
+            if(disc){
+                BITStarDisc planner(lower, map.upper, ClearanceCollision<2, float>(map.obstacles, map.field, request.robotRadius),
+                                    start, goal, request.goalRadius, 100, iterations);
+                plan(planner, request, stop, reply);
+            }else{
+                BITStar planner(lower, map.upper, ObstacleCollision<2, float>(map.obstacles),
+                                start, goal, request.goalRadius, 100, iterations);
+                plan(planner, request, stop, reply);
+            }
+        }else if(request.planner == static_cast<uint8_t>(PlannerKind::RRT_STAR)){
+            if(disc){
+                RRTStarDisc planner(lower, map.upper, ClearanceCollision<2, float>(map.obstacles, map.field, request.robotRadius),
+                                    start, goal, request.goalRadius, 70, 30, iterations);
+                plan(planner, request, stop, reply);
+            }else{
+                RRTStar planner(lower, map.upper, ObstacleCollision<2, float>(map.obstacles),
+                                start, goal, request.goalRadius, 70, 30, iterations);
+                plan(planner, request, stop, reply);
+            }
+        }else{
+            job.connection->send(MessageType::ERROR, job.requestId, "Unknown planner.");
+            return;
+        }
+    }catch(RRTStartConfigExcption& e){
+        job.connection->send(MessageType::ERROR, job.requestId, e.message);
+        return;
+    }catch(const std::exception& e){
+        job.connection->send(MessageType::ERROR, job.requestId, e.what());
+        return;
+    }
+    job.connection->send(MessageType::RESULT, job.requestId, reply);
+}
+
+// Read the connection's requests until it closes, answering map listings directly and
+// queueing plans for the workers.
+void serve(std::shared_ptr<Connection> connection, WorkerPool& pool, const std::string& mapList){
+    Header header;
+    std::string payload;
+    while(ReadFully(connection->fd, &header, sizeof(header))){
+        if(header.magic != MAGIC || header.version != VERSION || header.size > MAX_PAYLOAD){
+            connection->send(MessageType::ERROR, header.requestId, "Bad message header.");
+            return;
+        }
+        payload.resize(header.size);
+        if(!ReadFully(connection->fd, payload.data(), payload.size())){
+            return;
+        }
+
+        MessageType type = static_cast<MessageType>(header.type);
+        if(type == MessageType::LIST_MAPS){
+            connection->send(MessageType::MAPS, header.requestId, mapList);
+        }else if(type == MessageType::PLAN && payload.size() == sizeof(PlanRequest)){
+            Job job{connection, header.requestId, {}};
+            std::memcpy(&job.request, payload.data(), sizeof(PlanRequest));
+            if(!pool.submit(std::move(job))){
+                return;
+            }
+        }else{
+            connection->send(MessageType::ERROR, header.requestId, "Unexpected message.");
+        }
+    }
+}
+
+void usage(){
+    std::printf("e.g. ./plannerd <socket path> <name>=<map file>[@<width>x<height>]... [-j workers]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        usage();
+        return 1;
+    }
+    std::string socketPath = argv[1];
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::map<std::string, std::unique_ptr<ResidentMap>> maps;
+    std::string mapList;
+    for(int i = 2; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "-j" && i + 1 < argc){
+            workers = std::max(1, std::atoi(argv[++i]));
+            continue;
+        }
+        size_t equals = arg.find('=');
+        if(equals == std::string::npos || equals == 0 || equals >= MAP_NAME_SIZE){
+            usage();
+            return 1;
+        }
+        std::string name = arg.substr(0, equals);
+        std::string file = arg.substr(equals + 1);
+        float width = 640;
+        float height = 480;
+        size_t at = file.rfind('@');
+        if(at != std::string::npos){
+            if(std::sscanf(file.c_str() + at + 1, "%fx%f", &width, &height) != 2 || width <= 0 || height <= 0){
+                usage();
+                return 1;
+            }
+            file.resize(at);
+        }
+
+        auto loadStart = std::chrono::steady_clock::now();
+        try{
+            maps[name] = std::make_unique<ResidentMap>(file, width, height);
+        }catch(const std::exception& e){
+            std::fprintf(stderr, "Unable to load map '%s' from %s: %s\n", name.c_str(), file.c_str(), e.what());
+            return 1;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        std::printf("Loaded map '%s' from %s (%gx%g) in %.1f ms\n", name.c_str(), file.c_str(), width, height, ms);
+        mapList += name + "\n";
+    }
+
+    sockaddr_un address;
+    if(!SocketAddress(socketPath, address)){
+        std::fprintf(stderr, "Socket path too long: %s\n", socketPath.c_str());
+        return 1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0){
+        std::perror("Unable to listen on socket");
+        return 1;
+    }
+
+    // Every thread started from here on leaves the shutdown signals to the one waiting for
+    // them, and a client hanging up mid reply is a failed write rather than SIGPIPE.
+    std::signal(SIGPIPE, SIG_IGN);
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::atomic<bool> stopping{false};
+    std::thread signalWaiter([&](){
+        int signal;
+        sigwait(&signals, &signal);
+        stopping = true;
+        shutdown(listener, SHUT_RDWR);
+    });
+
+    WorkerPool pool(workers, [&](const Job& job, std::stop_token stop){ handle(maps, job, stop); });
+    std::printf("Serving %zu map(s) on %s with %d workers\n", maps.size(), socketPath.c_str(), workers);
+    std::fflush(stdout);
+
+    std::vector<Reader> readers;
+    while(!stopping){
+        int fd = accept(listener, nullptr, nullptr);
+        if(fd < 0){
+            if(errno == EINTR || errno == ECONNABORTED){
+                continue;
+            }
+            break;
+        }
+        // Join the readers whose clients have hung up since.
+        std::erase_if(readers, [](Reader& reader){
+            if(!*reader.finished){
+                return false;
+            }
+            reader.thread.join();
+            return true;
+        });
+        auto connection = std::make_shared<Connection>(fd);
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        std::thread thread([connection, finished, &pool, &mapList](){
+            serve(connection, pool, mapList);
+            *finished = true;
+        });
+        readers.push_back({std::move(thread), connection, finished});
+    }
+    if(!stopping){
+        // The listener failed by itself, so wake the signal thread to join it.
+        std::perror("accept");
+        pthread_kill(signalWaiter.native_handle(), SIGTERM);
+    }
+    signalWaiter.join();
+
+    // Cancel the searches, then unblock the readers by shutting their sockets.
+    pool.stop();
+    for(Reader& reader : readers){
+        if(auto connection = reader.connection.lock()){
+            shutdown(connection->fd, SHUT_RDWR);
+        }
+        reader.thread.join();
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+    std::printf("Shut down\n");
+    return 0;
+}
@@ -0,0 +1,707 @@
+#ifndef BIT_STAR_HPP
+#define BIT_STAR_HPP
+
+#include "Math.hpp"
+#include "Obstacles.hpp"
+#include "Metrics.hpp"
+#include "NearestNeighbors.hpp"
+#include "CollisionCheckers.hpp"
+#include "RRT.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <numbers>
+#include <queue>
+#include <random>
+#include <stop_token>
+#include <type_traits>
+#include <vector>
+
+/// @brief Batch Informed Trees (Gammell, Srinivasa and Barfoot) over a D dimensional state
+///        space under the Euclidean metric. Rather than one sample per iteration, samples are
+///        drawn a batch at a time, once the path found is short enough only from the
+///        ellipsoid of states that could still shorten it. Every edge between the tree and
+///        the samples near it is queued by the cost of the best path it could be part of,
+///        and edges are collision checked in that order, so the search stops checking as
+///        soon as the rest cannot beat the path it has. The backends see their work in bulk,
+///        one radius query per expanded vertex and one batch of samples at a time.
+///        Offers the same resumable interface as RRTStarN.
+template <int D,
+          typename T = float,
+          typename Nearest = KdTreeNearest<D, T>,
+          typename Collision = ObstacleCollision<D, T>>
+class BITStarN{
+public:
+    using State = VectorN<D, T>;
+    using Metric = EuclideanMetric<D, T>;
+
+    /// @brief Construct a planner between start and the goal region.
+    /// @param lower Min value of each coordinate of the state space.
+    /// @param upper Max value of each coordinate of the state space.
+    /// @param collision Backend to test states and motions for collision.
+    /// @param start Point coordinates to start search at.
+    /// @param goal Point coordinates to center goal area in.
+    /// @param goalRadius Radius from goal to consider completed goal.
+    /// @param batchSize Samples drawn per batch.
+    /// @param maxBatches Batches after which the search finishes.
+    BITStarN(const State& lower,
+             const State& upper,
+             Collision collision,
+             const State& start,
+             const State& goal,
+             T goalRadius,
+             int batchSize = 100,
+             int maxBatches = 100);
+
+    /// @brief Construct a planner over the plane [0, xMax) x [0, yMax) avoiding obs.
+    ///        See the constructor above for the remaining parameters.
+    BITStarN(int xMax,
+             int yMax,
+             Obstacles& obs,
+             const State& start,
+             const State& goal,
+             int goalRadius,
+             int batchSize = 100,
+             int maxBatches = 100) requires (D == 2 && std::is_constructible_v<Collision, Obstacles&>)
+        : BITStarN(State(0, 0), State(xMax, yMax), Collision(obs), start, goal, goalRadius, batchSize, maxBatches){
+    }
+
+    /// @brief Find a path from the start to the goal region, stopping at the first one found.
+    /// @return List of waypoints to travel between, from the goal back to the start.
+    std::vector<State> findBestPath();
+
+    /// @brief Start a new search, discarding any previous one, see RRTStarN::beginSearch.
+    void beginSearch(bool stopAtFirstPath = false);
+
+    /// @brief Continue the search for up to the given number of iterations, each one expanding
+    ///        a vertex, processing an edge or drawing a batch.
+    PlanStatus step(int iterations, std::stop_token stop = {}){
+        return run(iterations, std::chrono::steady_clock::time_point::max(), stop);
+    }
+
+    /// @brief Continue the search until budget has elapsed, otherwise as step.
+    template <typename Rep, typename Period>
+    PlanStatus runFor(std::chrono::duration<Rep, Period> budget, std::stop_token stop = {}){
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+        return run(std::numeric_limits<int>::max(), deadline, stop);
+    }
+
+    /// @brief Best path found so far, waypoints from the goal back to the start. Empty if the goal
+    ///        has not been reached. Brought up to date whenever step or runFor returns.
+    const std::vector<State>& bestPath() const{
+        return m_path;
+    }
+
+    bool hasPath() const{
+        return !m_path.empty();
+    }
+
+    /// @brief Retrieve the cost of the best path found so far.
+    T getCost() const{
+        return m_pathCost;
+    }
+
+    /// @brief Seed the random samples in place of the clock, see RRTStarN::setSeed.
+    void setSeed(unsigned seed){
+        m_rng.seed(seed);
+    }
+
+    /// @brief Batches of samples drawn in the current search.
+    int batches() const{
+        return m_batch;
+    }
+
+    /// @brief Edges collision checked in the current search.
+    long edgesChecked() const{
+        return m_edgesChecked;
+    }
+
+    /// @brief Edges queued in the current search, most never needing a collision check.
+    long edgesQueued() const{
+        return m_edgesQueued;
+    }
+
+private:
+    enum class Kind{
+        FREE,    //< Unused slot.
+        SAMPLE,  //< Not connected to the tree yet.
+        VERTEX   //< In the tree.
+    };
+
+    struct Node{
+        State state;
+        Kind kind;
+        int parent;                 //< Tree parent of a vertex, -1 for the root and samples.
+        T cost;                     //< Cost to come through the tree, infinite for samples.
+        std::vector<int> children;  //< Tree children of a vertex.
+        int batchAdded;             //< Batch in which the node last joined or moved in the tree.
+        int batchExpanded;          //< Batch in which the vertex was last expanded, -1 if none.
+    };
+
+    // A queued edge from vertex `from` to node `to`, estimated to be on a path costing key.
+    struct Edge{
+        T key;
+        int from;
+        int to;
+        bool operator>(const Edge& other) const{
+            return key > other.key;
+        }
+    };
+
+    // A queued vertex, estimated to be on a path costing key.
+    struct QueuedVertex{
+        T key;
+        int vertex;
+        bool operator>(const QueuedVertex& other) const{
+            return key > other.key;
+        }
+    };
+
+    std::vector<Node> m_nodes;     //< Samples and vertices alike, by slot.
+    std::vector<int> m_freeSlots;  //< Slots of pruned nodes, taken before m_nodes grows.
+    Nearest m_samples;             //< Index over the samples.
+    Nearest m_vertices;            //< Index over the vertices.
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> m_edgeQueue;
+    std::priority_queue<QueuedVertex, std::vector<QueuedVertex>, std::greater<QueuedVertex>> m_vertexQueue;
+    std::vector<int> m_near;       //< Scratch list reused by every radius query.
+
+    State m_lower;
+    State m_upper;
+    Collision m_collision;
+    State m_start;
+    State m_goal;
+    T m_goalRadius;
+    int m_batchSize;
+    int m_maxBatches;
+    std::mt19937 m_rng;
+
+    int m_batch = 0;               //< Batches drawn in the current search.
+    T m_radius = 0;                //< Connection radius for the current batch.
+    int m_bestGoal = -1;           //< Cheapest vertex in the goal region, -1 if none yet.
+    size_t m_sampleCount = 0;
+    size_t m_vertexCount = 0;
+    long m_edgesChecked = 0;
+    long m_edgesQueued = 0;
+    bool m_stopAtFirstPath = false;
+    bool m_done = false;
+    std::vector<State> m_path;
+    T m_pathCost = 0;
+
+    static constexpr T INFINITE_COST = std::numeric_limits<T>::infinity();
+
+    // Run iterations until the count or deadline is reached, the search finishes or stop is requested.
+    PlanStatus run(int iterations, std::chrono::steady_clock::time_point deadline, std::stop_token stop);
+
+    // Expand a vertex, process an edge or draw the next batch, whichever comes next.
+    void iterate();
+
+    bool finished() const{
+        return m_done || (m_stopAtFirstPath && m_bestGoal != -1);
+    }
+
+    // Cost of the best path so far, infinite if none.
+    T bestCost() const{
+        return m_bestGoal == -1 ? INFINITE_COST : m_nodes[m_bestGoal].cost;
+    }
+
+    // Straight line cost from the start, and on to the goal region, no more than any path's.
+    T costToCome(const State& s) const{
+        return Metric::distance(m_start, s);
+    }
+
+    T costToGo(const State& s) const{
+        return std::max(T(0), Metric::distance(s, m_goal) - m_goalRadius);
+    }
+
+    bool inGoal(const State& s) const{
+        return Metric::distance(s, m_goal) <= m_goalRadius;
+    }
+
+    // Drop stale entries off the top of both queues: vertices since pruned, already expanded or
+    // queued again with a lower cost, and edges from nodes no longer in the tree.
+    void cleanQueues();
+
+    // Prune, draw a batch of samples and queue every vertex for expansion.
+    void newBatch();
+
+    // Queue the edges from vertex v to the samples near it, and to the vertices near it if v is
+    // new to the tree in this batch, that could still be part of a better path.
+    void expand(int v);
+
+    // Collision check the edge and add it to the tree if it improves the cost of its target.
+    void processEdge(const Edge& edge);
+
+    // Remove the samples and vertices that cannot be part of a path cheaper than the best.
+    // Vertices cut off from the tree that could still help go back to being samples.
+    void prune();
+
+    // A free state uniformly from the ellipsoid of states that could be on a path cheaper than
+    // maxCost, or from the whole space while that is smaller or there is no path yet.
+    bool drawSample(T maxCost, State& out);
+
+    int newNode(const State& state, Kind kind);
+    void freeNode(int index);
+
+    // Bring the costs below a vertex up to date after its own changed.
+    void updateDescendants(int v);
+
+    void updateBestPath();
+};
+
+/// The planar BIT* planner, compiled once in BITStar.cpp.
+using BITStar = BITStarN<2, float>;
+
+extern template class BITStarN<2, float>;
+
+template <int D, typename T, typename Nearest, typename Collision>
+BITStarN<D, T, Nearest, Collision>::BITStarN(const State& lower,
+            const State& upper,
+            Collision collision,
+            const State& start,
+            const State& goal,
+            T goalRadius,
+            int batchSize,
+            int maxBatches)
+    : m_lower(lower), m_upper(upper), m_collision(std::move(collision)), m_start(start), m_goal(goal),
+      m_goalRadius(goalRadius), m_batchSize(batchSize), m_maxBatches(maxBatches)
+{
+    if(m_collision.inCollision(start)){
+        throw RRTStartConfigExcption("Cannot set start location within an obstacle.");
+    }
+    m_rng.seed(std::time(0));
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+std::vector<typename BITStarN<D, T, Nearest, Collision>::State> BITStarN<D, T, Nearest, Collision>::findBestPath()
+{
+    beginSearch(true);
+    step(std::numeric_limits<int>::max());
+    return m_path;
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::beginSearch(bool stopAtFirstPath)
+{
+    m_nodes.clear();
+    m_freeSlots.clear();
+    m_samples.clear();
+    m_vertices.clear();
+    m_edgeQueue = {};
+    m_vertexQueue = {};
+    m_batch = 0;
+    m_bestGoal = -1;
+    m_sampleCount = 0;
+    m_vertexCount = 0;
+    m_edgesChecked = 0;
+    m_edgesQueued = 0;
+    m_stopAtFirstPath = stopAtFirstPath;
+    m_done = false;
+    m_path.clear();
+    m_pathCost = 0;
+
+    int root = newNode(m_start, Kind::VERTEX);
+    m_nodes[root].cost = 0;
+    if(inGoal(m_start)){
+        m_bestGoal = root;
+    }
+    if(!m_collision.inCollision(m_goal)){
+        newNode(m_goal, Kind::SAMPLE);
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+PlanStatus BITStarN<D, T, Nearest, Collision>::run(int iterations, std::chrono::steady_clock::time_point deadline, std::stop_token stop)
+{
+    if(m_nodes.empty()){
+        beginSearch();
+    }
+
+    PlanStatus status = PlanStatus::RUNNING;
+    for(int i = 0; i < iterations; i++){
+        if(finished()){
+            break;
+        }
+        if(stop.stop_requested()){
+            status = PlanStatus::CANCELLED;
+            break;
+        }
+        if(deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline){
+            break;
+        }
+        iterate();
+    }
+
+    updateBestPath();
+    if(status != PlanStatus::CANCELLED && finished()){
+        status = PlanStatus::FINISHED;
+    }
+    return status;
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::iterate()
+{
+    cleanQueues();
+    T best = bestCost();
+    T vertexKey = m_vertexQueue.empty() ? INFINITE_COST : m_vertexQueue.top().key;
+    T edgeKey = m_edgeQueue.empty() ? INFINITE_COST : m_edgeQueue.top().key;
+
+    // Nothing queued can lead to a better path, on to the next batch.
+    if(std::min(vertexKey, edgeKey) >= best){
+        if(m_batch >= m_maxBatches){
+            m_done = true;
+            return;
+        }
+        newBatch();
+        return;
+    }
+
+    // Expand vertices until the best edge is at least as good as any an expansion could add.
+    if(vertexKey <= edgeKey){
+        int v = m_vertexQueue.top().vertex;
+        m_vertexQueue.pop();
+        expand(v);
+        return;
+    }
+
+    Edge edge = m_edgeQueue.top();
+    m_edgeQueue.pop();
+    processEdge(edge);
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::cleanQueues()
+{
+    while(!m_vertexQueue.empty()){
+        const QueuedVertex& q = m_vertexQueue.top();
+        const Node& n = m_nodes[q.vertex];
+        if(n.kind == Kind::VERTEX && n.batchExpanded != m_batch && q.key == n.cost + costToGo(n.state)){
+            break;
+        }
+        m_vertexQueue.pop();
+    }
+    while(!m_edgeQueue.empty() && m_nodes[m_edgeQueue.top().from].kind != Kind::VERTEX){
+        m_edgeQueue.pop();
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::newBatch()
+{
+    m_batch++;
+    if(m_bestGoal != -1){
+        prune();
+    }
+
+    // Draw the batch, all of it going into the sample index together.
+    T best = bestCost();
+    State s;
+    for(int i = 0; i < m_batchSize; i++){
+        if(drawSample(best, s)){
+            newNode(s, Kind::SAMPLE);
+        }
+    }
+
+    // Connection radius gamma (log q / q)^(1/D) over the q states in play, gamma scaled to
+    // the volume still worth sampling as in RRTStarN.
+    T boxVolume = 1;
+    for(int i = 0; i < D; i++){
+        boxVolume *= m_upper[i] - m_lower[i];
+    }
+    T unitBall = std::pow(std::numbers::pi_v<T>, D / T(2)) / std::tgamma(D / T(2) + 1);
+    T volume = boxVolume;
+    if(m_bestGoal != -1){
+        T focal = Metric::distance(m_start, m_goal);
+        T transverse = best + m_goalRadius;
+        T conjugate = std::sqrt(std::max(T(0), transverse * transverse - focal * focal));
+        volume = std::min(boxVolume, unitBall * (transverse / 2) * std::pow(conjugate / 2, T(D - 1)));
+    }
+    T gamma = T(1.1) * 2 * std::pow((1 + T(1) / D) * volume / unitBall, T(1) / D);
+    T q = m_sampleCount + m_vertexCount;
+    m_radius = gamma * std::pow(std::log(q) / q, T(1) / D);
+
+    // Every vertex gets expanded again against the new samples.
+    m_edgeQueue = {};
+    m_vertexQueue = {};
+    for(size_t i = 0; i < m_nodes.size(); i++){
+        const Node& n = m_nodes[i];
+        if(n.kind == Kind::VERTEX){
+            m_vertexQueue.push({n.cost + costToGo(n.state), int(i)});
+        }
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::expand(int v)
+{
+    m_nodes[v].batchExpanded = m_batch;
+    const State vState = m_nodes[v].state;
+    const T vCost = m_nodes[v].cost;
+    const T best = bestCost();
+
+    m_samples.withinRadius(vState, m_radius, m_near);
+    for(int x : m_near){
+        const State& xState = m_nodes[x].state;
+        T key = vCost + Metric::distance(vState, xState) + costToGo(xState);
+        if(key < best){
+            m_edgeQueue.push({key, v, x});
+            m_edgesQueued++;
+        }
+    }
+
+    // Vertices in the tree since before this batch already had their chance to rewire the others.
+    if(m_nodes[v].batchAdded != m_batch){
+        return;
+    }
+    m_vertices.withinRadius(vState, m_radius, m_near);
+    for(int w : m_near){
+        const Node& n = m_nodes[w];
+        if(w == v || n.parent == v || m_nodes[v].parent == w){
+            continue;
+        }
+        T edge = Metric::distance(vState, n.state);
+        T key = vCost + edge + costToGo(n.state);
+        if(key < best && vCost + edge < n.cost){
+            m_edgeQueue.push({key, v, w});
+            m_edgesQueued++;
+        }
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::processEdge(const Edge& edge)
+{
+    Node& from = m_nodes[edge.from];
+    Node& to = m_nodes[edge.to];
+    if(to.kind == Kind::FREE){
+        return;
+    }
+
+    // The costs may have dropped since the edge was queued, so check them again before paying
+    // for the collision check.
+    T length = Metric::distance(from.state, to.state);
+    T cost = from.cost + length;
+    if(cost + costToGo(to.state) >= bestCost() || cost >= to.cost){
+        return;
+    }
+    m_edgesChecked++;
+    if(m_collision.segmentInCollision(from.state, to.state)){
+        return;
+    }
+
+    if(to.kind == Kind::VERTEX){
+        // Rewire, moving the vertex and everything below it onto the cheaper edge.
+        std::vector<int>& siblings = m_nodes[to.parent].children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), edge.to), siblings.end());
+    }else{
+        m_samples.remove(edge.to);
+        m_vertices.add(edge.to, to.state);
+        to.kind = Kind::VERTEX;
+        m_sampleCount--;
+        m_vertexCount++;
+    }
+    to.parent = edge.from;
+    to.cost = cost;
+    to.batchAdded = m_batch;
+    to.batchExpanded = -1;
+    from.children.push_back(edge.to);
+    m_vertexQueue.push({cost + costToGo(to.state), edge.to});
+    updateDescendants(edge.to);
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::updateDescendants(int v)
+{
+    std::vector<int> pending = {v};
+    while(!pending.empty()){
+        int i = pending.back();
+        pending.pop_back();
+        const Node& n = m_nodes[i];
+        if(n.parent != -1){
+            m_nodes[i].cost = m_nodes[n.parent].cost + Metric::distance(m_nodes[n.parent].state, n.state);
+        }
+        if(inGoal(n.state) && n.cost < bestCost()){
+            m_bestGoal = i;
+        }
+        pending.insert(pending.end(), n.children.begin(), n.children.end());
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::prune()
+{
+    const T best = bestCost();
+    auto estimate = [&](const State& s){ return costToCome(s) + costToGo(s); };
+
+    for(size_t i = 0; i < m_nodes.size(); i++){
+        if(m_nodes[i].kind == Kind::SAMPLE && estimate(m_nodes[i].state) >= best){
+            freeNode(i);
+        }
+    }
+
+    // Keep the vertices reachable from the root through vertices that could still help, and
+    // the best path's own, which rounding could otherwise put a hair over the bound.
+    std::vector<char> keep(m_nodes.size(), 0);
+    for(int i = m_bestGoal; i != -1; i = m_nodes[i].parent){
+        keep[i] = 1;
+    }
+    std::vector<int> pending = {0};
+    keep[0] = 1;
+    while(!pending.empty()){
+        int i = pending.back();
+        pending.pop_back();
+        std::vector<int>& children = m_nodes[i].children;
+        std::erase_if(children, [&](int c){
+            return !keep[c] && estimate(m_nodes[c].state) > best;
+        });
+        for(int c : children){
+            keep[c] = 1;
+            pending.push_back(c);
+        }
+    }
+
+    for(size_t i = 0; i < m_nodes.size(); i++){
+        Node& n = m_nodes[i];
+        if(n.kind != Kind::VERTEX || keep[i]){
+            continue;
+        }
+        if(estimate(n.state) < best){
+            // Cut off from the tree but still promising, try connecting it again.
+            m_vertices.remove(i);
+            m_samples.add(i, n.state);
+            n.kind = Kind::SAMPLE;
+            n.parent = -1;
+            n.cost = INFINITE_COST;
+            std::vector<int>().swap(n.children);
+            m_vertexCount--;
+            m_sampleCount++;
+        }else{
+            freeNode(i);
+        }
+    }
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+bool BITStarN<D, T, Nearest, Collision>::drawSample(T maxCost, State& out)
+{
+    T boxVolume = 1;
+    for(int i = 0; i < D; i++){
+        boxVolume *= m_upper[i] - m_lower[i];
+    }
+    T unitBall = std::pow(std::numbers::pi_v<T>, D / T(2)) / std::tgamma(D / T(2) + 1);
+
+    // The states x with |start - x| + |x - goal| < maxCost + goalRadius, an ellipsoid with the
+    // start and the goal's center as foci.
+    T focal = Metric::distance(m_start, m_goal);
+    T transverse = maxCost + m_goalRadius;
+    T conjugate = std::sqrt(std::max(T(0), transverse * transverse - focal * focal));
+    bool informed = maxCost < INFINITE_COST && focal > 0
+                    && unitBall * (transverse / 2) * std::pow(conjugate / 2, T(D - 1)) < boxVolume;
+
+    // The reflection taking the first axis onto the direction from start to goal.
+    State axis;
+    State w;
+    T wLength = 0;
+    if(informed){
+        for(int i = 0; i < D; i++){
+            axis[i] = (m_goal[i] - m_start[i]) / focal;
+            w[i] = (i == 0 ? 1 : 0) - axis[i];
+            wLength += w[i] * w[i];
+        }
+    }
+
+    std::uniform_real_distribution<T> unit(0, 1);
+    std::normal_distribution<T> normal(0, 1);
+    for(int attempt = 0; attempt < 1000; attempt++){
+        if(informed){
+            // Uniform in the unit ball, stretched into the ellipsoid and turned into place.
+            State ball;
+            T length = 0;
+            for(int i = 0; i < D; i++){
+                ball[i] = normal(m_rng);
+                length += ball[i] * ball[i];
+            }
+            T scale = std::pow(unit(m_rng), T(1) / D) / std::sqrt(length);
+            for(int i = 0; i < D; i++){
+                ball[i] *= scale * (i == 0 ? transverse : conjugate) / 2;
+            }
+            T dot = 0;
+            for(int i = 0; i < D; i++){
+                dot += w[i] * ball[i];
+            }
+            for(int i = 0; i < D; i++){
+                T reflected = wLength > 0 ? ball[i] - 2 * w[i] * dot / wLength : ball[i];
+                out[i] = (m_start[i] + m_goal[i]) / 2 + reflected;
+            }
+        }else{
+            for(int i = 0; i < D; i++){
+                out[i] = m_lower[i] + (m_upper[i] - m_lower[i]) * unit(m_rng);
+            }
+        }
+
+        bool inBounds = true;
+        for(int i = 0; i < D; i++){
+            inBounds = inBounds && out[i] >= m_lower[i] && out[i] <= m_upper[i];
+        }
+        if(inBounds && costToCome(out) + costToGo(out) < maxCost && !m_collision.inCollision(out)){
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+int BITStarN<D, T, Nearest, Collision>::newNode(const State& state, Kind kind)
+{
+    int index;
+    if(!m_freeSlots.empty()){
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }else{
+        index = m_nodes.size();
+        m_nodes.emplace_back();
+    }
+    m_nodes[index] = {state, kind, -1, INFINITE_COST, {}, m_batch, -1};
+    if(kind == Kind::VERTEX){
+        m_vertices.add(index, state);
+        m_vertexCount++;
+    }else{
+        m_samples.add(index, state);
+        m_sampleCount++;
+    }
+    return index;
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::freeNode(int index)
+{
+    Node& n = m_nodes[index];
+    if(n.kind == Kind::VERTEX){
+        m_vertices.remove(index);
+        m_vertexCount--;
+    }else if(n.kind == Kind::SAMPLE){
+        m_samples.remove(index);
+        m_sampleCount--;
+    }
+    n.kind = Kind::FREE;
+    std::vector<int>().swap(n.children);
+    m_freeSlots.push_back(index);
+}
+
+template <int D, typename T, typename Nearest, typename Collision>
+void BITStarN<D, T, Nearest, Collision>::updateBestPath()
+{
+    if(m_bestGoal == -1){
+        return;
+    }
+    m_path.clear();
+    for(int i = m_bestGoal; i != -1; i = m_nodes[i].parent){
+        m_path.push_back(m_nodes[i].state);
+    }
+    m_pathCost = m_nodes[m_bestGoal].cost;
+}
+
+#endif
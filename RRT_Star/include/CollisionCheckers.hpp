@@ -0,0 +1,130 @@
+#ifndef COLLISION_CHECKERS_HPP
+#define COLLISION_CHECKERS_HPP
+
+#include "Math.hpp"
+#include "Obstacles.hpp"
+#include "DistanceField.hpp"
+#include "QuadTree.hpp"
+
+// Collision backends for the planner. A backend answers whether a state, or the straight
+// motion between two states, hits an obstacle. Any class with the same members can be
+// swapped in through RRTStarN's template parameters.
+
+/// @brief Test against the polygon obstacles, which lie in the plane of the first two
+///        coordinates and extend unchanged through any further ones (height, heading).
+template <int D, typename T>
+class ObstacleCollision{
+public:
+    using State = VectorN<D, T>;
+
+    ObstacleCollision(const Obstacles& obs) : m_obs(&obs){
+    }
+
+    bool inCollision(const State& state) const{
+        return m_obs->inObstacles(project(state));
+    }
+
+    // The motion between two states projects onto the straight segment between their
+    // projections, so the 2D segment test is exact for these extruded obstacles.
+    bool segmentInCollision(const State& a, const State& b) const{
+        return m_obs->segmentInObstacles(project(a), project(b));
+    }
+
+    const Obstacles& obstacles() const{
+        return *m_obs;
+    }
+
+private:
+    const Obstacles* m_obs;
+
+    static Vector2f project(const State& state){
+        return Vector2f(static_cast<float>(state[0]), static_cast<float>(state[1]));
+    }
+};
+
+/// @brief A disc shaped robot of the given radius among the same extruded obstacles. Most
+///        motions are nowhere near an obstacle, and the distance field proves those free
+///        from three lookups. Only the rest are tested exactly against the polygons.
+template <int D, typename T>
+class ClearanceCollision{
+public:
+    using State = VectorN<D, T>;
+
+    /// @param field Distance field built from obs over the workspace.
+    /// @param radius Radius of the robot.
+    ClearanceCollision(const Obstacles& obs, const DistanceField& field, float radius)
+        : m_obs(&obs), m_field(&field), m_radius(radius){
+    }
+
+    bool inCollision(const State& state) const{
+        Vector2f p = project(state);
+        return !m_field->provesFree(p, m_radius) && m_obs->inObstacles(p, m_radius);
+    }
+
+    bool segmentInCollision(const State& a, const State& b) const{
+        Vector2f pa = project(a);
+        Vector2f pb = project(b);
+        return !m_field->provesFree(pa, pb, m_radius) && m_obs->segmentInObstacles(pa, pb, m_radius);
+    }
+
+    const Obstacles& obstacles() const{
+        return *m_obs;
+    }
+
+    const DistanceField& field() const{
+        return *m_field;
+    }
+
+    float radius() const{
+        return m_radius;
+    }
+
+private:
+    const Obstacles* m_obs;
+    const DistanceField* m_field;
+    float m_radius;
+
+    static Vector2f project(const State& state){
+        return Vector2f(static_cast<float>(state[0]), static_cast<float>(state[1]));
+    }
+};
+
+/// @brief Test against the same extruded obstacles through an OccupancyQuadTree, which answers
+///        from its free and full leaves without touching the polygons. Suits huge, sparse
+///        workspaces that a distance field would need gigabytes to cover.
+template <int D, typename T>
+class QuadTreeCollision{
+public:
+    using State = VectorN<D, T>;
+
+    /// @param tree Quadtree built from the obstacles over the workspace.
+    /// @param radius Radius of a disc shaped robot, 0 for a point.
+    QuadTreeCollision(const OccupancyQuadTree& tree, float radius = 0) : m_tree(&tree), m_radius(radius){
+    }
+
+    bool inCollision(const State& state) const{
+        return m_tree->inObstacles(project(state), m_radius);
+    }
+
+    bool segmentInCollision(const State& a, const State& b) const{
+        return m_tree->segmentInObstacles(project(a), project(b), m_radius);
+    }
+
+    const Obstacles& obstacles() const{
+        return m_tree->obstacles();
+    }
+
+    const OccupancyQuadTree& tree() const{
+        return *m_tree;
+    }
+
+private:
+    const OccupancyQuadTree* m_tree;
+    float m_radius;
+
+    static Vector2f project(const State& state){
+        return Vector2f(static_cast<float>(state[0]), static_cast<float>(state[1]));
+    }
+};
+
+#endif
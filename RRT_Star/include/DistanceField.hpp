@@ -0,0 +1,82 @@
+#ifndef DISTANCE_FIELD_HPP
+#define DISTANCE_FIELD_HPP
+
+#include "Math.hpp"
+#include "Obstacles.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/// @brief Signed distance to the obstacles, sampled on a grid of square cells over the
+///        workspace [0, xMax] x [0, yMax]. Built once from the polygons, after which a lookup
+///        is a single array read. Outside the obstacles each cell holds a lower bound on the
+///        clearance of every point in the cell, so a large enough value proves a disc free
+///        without touching the polygons. Inside, the values are only an estimate of the depth.
+///        Read only once built, so any number of threads may query it at once.
+class DistanceField{
+public:
+
+    /// @param obs Obstacles to measure the distance to.
+    /// @param xMax Width of the workspace.
+    /// @param yMax Height of the workspace.
+    /// @param cellSize Side of each cell. The bounds are looser by about 1.5 cells.
+    DistanceField(const Obstacles& obs, float xMax, float yMax, float cellSize = 1);
+
+    /// @brief Signed distance at p, negative inside an obstacle. Never more than the true
+    ///        clearance outside them, and 0 anywhere outside the workspace.
+    float distance(const Vector2f& p) const{
+        if(!(p.x >= 0 && p.y >= 0 && p.x < m_cols * m_cellSize && p.y < m_rows * m_cellSize)){
+            return 0;
+        }
+        int c = std::min(int(p.x / m_cellSize), m_cols - 1);
+        int r = std::min(int(p.y / m_cellSize), m_rows - 1);
+        return m_distance[r * m_cols + c];
+    }
+
+    /// @brief True if the field proves a disc of the given radius at p clear of the obstacles.
+    ///        False means the field cannot tell, not that it collides.
+    bool provesFree(const Vector2f& p, float radius) const{
+        return distance(p) > radius;
+    }
+
+    /// @brief True if the field proves a disc of the given radius clear of the obstacles all the
+    ///        way from a to b. The distance moves by at most as much as the point does, so a
+    ///        disc of its clearance around each of a and b is free, and the segment is covered
+    ///        when those discs, less the radius, overlap along it. If they do not, the
+    ///        midpoint's disc is tried in between, and so on down to a few levels.
+    ///        False means the field cannot tell, not that it collides.
+    bool provesFree(const Vector2f& a, const Vector2f& b, float radius) const{
+        float ca = distance(a) - radius;
+        float cb = distance(b) - radius;
+        return ca > 0 && cb > 0 && covers(a, ca, b, cb, radius, Distance(a, b), SUBDIVISIONS);
+    }
+
+    float cellSize() const{
+        return m_cellSize;
+    }
+
+private:
+    static const int SUBDIVISIONS = 3; //< Levels of midpoints provesFree may try.
+
+    float m_cellSize;
+    int m_cols;
+    int m_rows;
+    std::vector<float> m_distance; //< Row major, one value per cell.
+
+    // True if the free discs around a and b, or those around midpoints in between, cover the
+    // segment, given each end's clearance beyond the radius.
+    bool covers(const Vector2f& a, float ca, const Vector2f& b, float cb, float radius, float length, int depth) const{
+        if(ca + cb > length){
+            return true;
+        }
+        if(depth == 0){
+            return false;
+        }
+        Vector2f m = CreateMidpoint(a, b);
+        float cm = distance(m) - radius;
+        return cm > 0 && covers(a, ca, m, cm, radius, length / 2, depth - 1)
+                      && covers(m, cm, b, cb, radius, length / 2, depth - 1);
+    }
+};
+
+#endif
@@ -1,3 +1,7 @@
+#ifndef HEADLESS
+#ifndef DRAW_UTILS_HPP
+#define DRAW_UTILS_HPP
+
 #if defined(LINUX) || defined(MINGW)
     #include <SDL2/SDL.h>
 #else // This works for Mac
@@ -6,11 +10,99 @@
 
 #include "Math.hpp"
 
+#include <vector>
+
 // Helper funciton to draw a circle at center with radius, done simply by
 // drawing dotted points around the circle for ease of implementation
-void drawDottedCircle(SDL_Renderer* renderer,  Vector2f& center, int radius);
+void drawDottedCircle(SDL_Renderer* renderer, const Vector2f& center, int radius);
 
 // Draw a thicker point
 void DrawPointScaled(SDL_Renderer* renderer, int x, int y, size_t size=2);
 
-void DrawThickLine(SDL_Renderer* renderer, int x, int y);
\ No newline at end of file
+/// @brief Collects lines and points as colored quads and submits them all with a single
+///        SDL_RenderGeometry call, instead of one draw call per line and per pixel. Its
+///        buffers keep their capacity across clear(), so refilling it every time the scene
+///        changes does not allocate once it has grown to the scene's size.
+class GeometryBatch{
+public:
+    void clear();
+
+    /// @brief Add a line from (x1, y1) to (x2, y2), width pixels wide.
+    void addLine(float x1, float y1, float x2, float y2, SDL_Color color, float width = 1);
+
+    /// @brief Add a size by size pixel square with its top left corner at (x, y).
+    void addPoint(float x, float y, SDL_Color color, float size = 2);
+
+    void render(SDL_Renderer* renderer) const;
+
+private:
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+
+    void addQuad(const SDL_FPoint corners[4], SDL_Color color);
+};
+
+/// @brief A window sized texture holding drawing that rarely changes, such as the obstacles
+///        or a finished tree. It is only painted again after invalidate(), otherwise each
+///        frame costs a single texture copy however much was drawn into it. Translucent
+///        drawing comes out the same as if it had been painted straight to the window.
+class CachedLayer{
+public:
+    CachedLayer() = default;
+    ~CachedLayer();
+
+    CachedLayer(const CachedLayer&) = delete;
+    CachedLayer& operator=(const CachedLayer&) = delete;
+
+    /// @brief Repaint the layer on its next render, e.g. after its data changed or the
+    ///        renderer lost its textures (SDL_RENDER_TARGETS_RESET).
+    void invalidate(){
+        m_dirty = true;
+    }
+
+    /// @brief Copy the layer to the renderer, first calling paint(renderer) to fill it if it
+    ///        was invalidated. Falls back to painting straight to the window every time if
+    ///        the renderer cannot render to textures.
+    template <typename Paint>
+    void render(SDL_Renderer* renderer, Paint paint){
+        if(!prepare(renderer)){
+            paint(renderer);
+            return;
+        }
+        if(m_dirty){
+            SDL_SetRenderTarget(renderer, m_texture);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderClear(renderer);
+            paint(renderer);
+            SDL_SetRenderTarget(renderer, nullptr);
+            m_dirty = false;
+        }
+        SDL_RenderCopy(renderer, m_texture, nullptr, nullptr);
+    }
+
+    /// @brief Paint more on top of what the layer already holds, for drawing that only grows.
+    ///        Does nothing if the layer is due to be repainted in full by render anyway, or
+    ///        cannot be cached at all.
+    template <typename Paint>
+    void paintOver(SDL_Renderer* renderer, Paint paint){
+        if(!prepare(renderer) || m_dirty){
+            return;
+        }
+        SDL_SetRenderTarget(renderer, m_texture);
+        paint(renderer);
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+private:
+    SDL_Texture* m_texture = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    bool m_dirty = true;
+    bool m_unsupported = false;
+
+    // Make sure the texture exists and matches the window size, true if it can be used.
+    bool prepare(SDL_Renderer* renderer);
+};
+
+#endif
+#endif
@@ -9,23 +9,116 @@
 
 #include <cmath> // for sqrt
 #include <cassert>
+#include <array>
 #include <vector>
 
+/*
+ * Represent a point or vector with D coordinates of scalar type T. The planner
+ * is templated on this so the same code can search the plane, 3D space or poses
+ * with a heading. The two dimensional case is specialized below so it keeps its
+ * named x and y members.
+ */
+template <int D, typename T = float>
+struct VectorN{
+    std::array<T, D> coords{};
+
+    /// Default constructor
+    /// Initializes vector values to 0 by default.
+    VectorN() = default;
+
+    /// One argument per coordinate.
+    template <typename... Ts>
+        requires (sizeof...(Ts) == D)
+    VectorN(Ts... values): coords{static_cast<T>(values)...}{
+    }
+
+    T& operator[](int i){
+        return coords[i];
+    }
+
+    const T& operator[](int i) const{
+        return coords[i];
+    }
+
+    /// Urnary Negation operator flips sign of vector.
+    VectorN operator-() const{
+        VectorN result;
+        for(int i = 0; i < D; i++){
+            result.coords[i] = -coords[i];
+        }
+        return result;
+    }
+
+    VectorN operator+(const VectorN& rhs) const{
+        VectorN result;
+        for(int i = 0; i < D; i++){
+            result.coords[i] = coords[i] + rhs.coords[i];
+        }
+        return result;
+    }
+
+    // Subtraction
+    VectorN operator-(const VectorN& rhs) const{
+        VectorN result;
+        for(int i = 0; i < D; i++){
+            result.coords[i] = coords[i] - rhs.coords[i];
+        }
+        return result;
+    }
+
+    // Subtract a vector from this one
+    VectorN& operator-=(const VectorN& rhs){
+        for(int i = 0; i < D; i++){
+            coords[i] -= rhs.coords[i];
+        }
+        return *this;
+    }
+
+    // Scale by a constant
+    VectorN operator*(T scale) const{
+        VectorN result;
+        for(int i = 0; i < D; i++){
+            result.coords[i] = coords[i] * scale;
+        }
+        return result;
+    }
+
+    // Normalize
+    VectorN& Normalize(){
+        T len = Magnitude();
+        assert(len != T(0) && "We actually found a float that is 0 (or maybe close), uh oh!");
+        for(int i = 0; i < D; i++){
+            coords[i] /= len;
+        }
+        return *this;
+    }
+
+    // Magnitude or "Length"
+    T Magnitude() const{
+        T sum = 0;
+        for(int i = 0; i < D; i++){
+            sum += coords[i] * coords[i];
+        }
+        return std::sqrt(sum);
+    }
+};
+
 /*
  * Represent a two dimensional float point or vetor
  */
-struct Vector2f{
-    float x,y;
+template <typename T>
+struct VectorN<2, T>{
+    T x,y;
 
     /// Default constructor
     /// Initializes vector values to 0.0f by default.
-    Vector2f(){
-        x=0.0f;
-        y=0.0f;
+    VectorN(){
+        x=T(0);
+        y=T(0);
     }
 
     /// Two argument constructor
-    Vector2f(float _x, float _y): x(_x), y(_y){
+    VectorN(T _x, T _y): x(_x), y(_y){
     }
 
     /// Copy Constructor
@@ -33,13 +126,13 @@ struct Vector2f{
     /// so I can debug when copies are made
     /// i.e. Add a 'print message' (or better yet -- see in the debugger)
     ///      when this is being called.
-    Vector2f(const Vector2f& rhs){
+    VectorN(const VectorN& rhs){
         x = rhs.x;
         y = rhs.y;
     }
 
     /// Copy assignment operator
-    Vector2f& operator=(const Vector2f& rhs){
+    VectorN& operator=(const VectorN& rhs){
         if(this== &rhs){
             return *this;
         }
@@ -48,32 +141,46 @@ struct Vector2f{
         return *this;
     }
 
+    /// Coordinate access so dimension generic code can treat this like any VectorN.
+    T& operator[](int i){
+        return i == 0 ? x : y;
+    }
+
+    const T& operator[](int i) const{
+        return i == 0 ? x : y;
+    }
+
     /// Urnary Negation operator flips sign of vector.
     /// This produces a new vector.
-    Vector2f operator-() const{
-        return Vector2f(-x,-y);
+    VectorN operator-() const{
+        return VectorN(-x,-y);
     }
 
-    Vector2f operator+(const Vector2f& rhs) const{
-        return Vector2f(x+rhs.x, y+rhs.y);
+    VectorN operator+(const VectorN& rhs) const{
+        return VectorN(x+rhs.x, y+rhs.y);
     }
 
     // Subtraction
-    Vector2f operator-(const Vector2f& rhs) const{
-        return Vector2f(x-rhs.x, y-rhs.y);
+    VectorN operator-(const VectorN& rhs) const{
+        return VectorN(x-rhs.x, y-rhs.y);
     }
 
     // Subtract a vector from this one
-    Vector2f& operator-=(const Vector2f& rhs){
+    VectorN& operator-=(const VectorN& rhs){
         x -= rhs.x;
         y -= rhs.y;
         return *this;
     }
 
+    // Scale by a constant
+    VectorN operator*(T scale) const{
+        return VectorN(x*scale, y*scale);
+    }
+
     // Normalize
-    Vector2f& Normalize(){
-        float len = Magnitude();
-        assert(len != 0.0f && "We actually found a float that is 0 (or maybe close), uh oh!");
+    VectorN& Normalize(){
+        T len = Magnitude();
+        assert(len != T(0) && "We actually found a float that is 0 (or maybe close), uh oh!");
         x = x / len;
         y = y / len;
 
@@ -82,12 +189,16 @@ struct Vector2f{
     }
 
     // Magnitude or "Length"
-    float Magnitude(){
-        return sqrt(x*x + y*y);	
+    T Magnitude() const{
+        return std::sqrt(x*x + y*y);	
     }
 
 };
 
+using Vector2f = VectorN<2, float>;
+using Vector3f = VectorN<3, float>;
+using Vector4f = VectorN<4, float>;
+
 
 // Helpful class for storing the orientation between points.
 enum class ORIENTATION{COLLINEAR, CLOCKWISE, COUNTERCLOCKWISE};
@@ -106,16 +217,32 @@ float Cross(const Vector2f& a, const Vector2f& b);
 // Return the midpoint between two points.
 Vector2f CreateMidpoint(const Vector2f& a, const Vector2f& b);
 
-// Determine if a point is on the left hand size of a line segment.
+// Determine if a point is on the left hand size of a line segment. Returns +1 if
+// left, -1 if right and 0 if on the line, exactly, see Orient2D in Predicates.hpp.
 int isLeft(const Vector2f& a, const Vector2f& b, const Vector2f& point);
 
 // Compute the distance between two points.
 float Distance(const Vector2f& a, const Vector2f& b);
 
 // Determine the orientation between a triplet of points directed from 
-// p to q to r
+// p to q to r. Exact, so collinear is only reported for truly collinear points.
 ORIENTATION GetOrientation(Vector2f p, Vector2f q, Vector2f r);
 
+/// @brief Distance from a point to the closest point of a line segment.
+/// @param p Point to measure from.
+/// @param a First end point of segment.
+/// @param b Second end point of segment.
+/// @return Distance from p to the segment.
+float PointSegmentDistance(const Vector2f& p, const Vector2f& a, const Vector2f& b);
+
+/// @brief Distance between the closest points of two line segments.
+/// @param a1 First end point of segment one.
+/// @param b1 Second end point of segment one.
+/// @param a2 First end point of segment two.
+/// @param b2 Second end point of segment two.
+/// @return 0 if the segments intersect.
+float SegmentDistance(const Vector2f& a1, const Vector2f& b1, const Vector2f& a2, const Vector2f& b2);
+
 /// @brief Determine if a point lies on a line segment.
 /// @param a First end point of segment. 
 /// @param b Secomd end point of segment.
@@ -136,7 +263,7 @@ bool SegmentsIntersect(const Vector2f& a1, const Vector2f& b1, const Vector2f& a
 /// @param b Second end point of segment.
 /// @param triangle The triangle to test.
 /// @return True if the segment lies within the triangle at all.
-bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, std::vector<Vector2f>& triangle);
+bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, const std::array<Vector2f, 3>& triangle);
 
 
 /// @brief Test if a point is inside a triangle.
@@ -144,7 +271,23 @@ bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, std::vector<Vector2
 /// @param a First vertex of triangle.
 /// @param b Second vertex of triangle.
 /// @param c Thrid vertex of triangle.
-/// @return 
+/// @return True if the point is inside or on the triangle. The vertices must be
+///         in counter clockwise order.
 bool PointInTriangle(const Vector2f& v, const Vector2f& a, const Vector2f& b, const Vector2f& c);
 
+/// @brief Test if a point is inside a convex polygon, in O(log n) by locating the
+///        wedge of the fan from the first vertex that contains the point.
+/// @param v Point to test.
+/// @param polygon Vertices of the convex polygon in counter clockwise order.
+/// @return True if the point is inside or on the polygon, same boundary rule as PointInTriangle.
+bool PointInConvexPolygon(const Vector2f& v, const std::vector<Vector2f>& polygon);
+
+/// @brief Test if a line segment intersects or lies within a convex polygon by looking
+///        for a separating line among the polygon's edges and the segment itself.
+/// @param a First end point of segment.
+/// @param b Second end point of segment.
+/// @param polygon Vertices of the convex polygon in counter clockwise order.
+/// @return True if any part of the segment is inside or on the polygon.
+bool SegmentInConvexPolygon(const Vector2f& a, const Vector2f& b, const std::vector<Vector2f>& polygon);
+
 #endif
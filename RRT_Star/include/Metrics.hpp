@@ -0,0 +1,77 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "Math.hpp"
+
+#include <cmath>
+#include <numbers>
+
+// Distance metrics for the planner's state space. A metric provides the distance
+// between two states and the state a fraction t of the way from one to another,
+// which is all steering and rewiring need. They are plain static functions so the
+// planner calls them directly, no virtual dispatch.
+
+/// @brief Straight line distance over every coordinate.
+template <int D, typename T = float>
+struct EuclideanMetric{
+    using State = VectorN<D, T>;
+
+    static T distance(const State& a, const State& b){
+        T sum = 0;
+        for(int i = 0; i < D; i++){
+            T d = a[i] - b[i];
+            sum += d * d;
+        }
+        return std::sqrt(sum);
+    }
+
+    static State interpolate(const State& from, const State& to, T t){
+        State result;
+        for(int i = 0; i < D; i++){
+            result[i] = from[i] + (to[i] - from[i]) * t;
+        }
+        return result;
+    }
+};
+
+/// @brief Euclidean over the position coordinates with the last coordinate treated as
+///        a heading in radians, wrapped to [-pi, pi). Turning is weighted as HeadingWeight
+///        workspace units per radian, e.g. (x, y, z, heading) for a drone with D = 4.
+template <int D, typename T = float, int HeadingWeight = 20>
+struct HeadingMetric{
+    using State = VectorN<D, T>;
+    static_assert(D >= 2, "Need at least one position coordinate and a heading.");
+
+    // Shortest signed turn from heading a to heading b.
+    static T angleDifference(T a, T b){
+        const T pi = std::numbers::pi_v<T>;
+        T d = std::fmod(b - a + pi, 2 * pi);
+        if(d < 0){
+            d += 2 * pi;
+        }
+        return d - pi;
+    }
+
+    static T distance(const State& a, const State& b){
+        T sum = 0;
+        for(int i = 0; i < D - 1; i++){
+            T d = a[i] - b[i];
+            sum += d * d;
+        }
+        T turn = HeadingWeight * angleDifference(a[D - 1], b[D - 1]);
+        return std::sqrt(sum + turn * turn);
+    }
+
+    static State interpolate(const State& from, const State& to, T t){
+        State result;
+        for(int i = 0; i < D - 1; i++){
+            result[i] = from[i] + (to[i] - from[i]) * t;
+        }
+        // Turn the short way round, then wrap back into range.
+        T heading = from[D - 1] + angleDifference(from[D - 1], to[D - 1]) * t;
+        result[D - 1] = angleDifference(T(0), heading);
+        return result;
+    }
+};
+
+#endif
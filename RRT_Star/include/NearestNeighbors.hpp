@@ -0,0 +1,338 @@
+#ifndef NEAREST_NEIGHBORS_HPP
+#define NEAREST_NEIGHBORS_HPP
+
+#include "Math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Nearest neighbor backends for the planner. A backend keeps its own copy of the tree's
+// states under the planner's node indices, which are reused once a pruned node's slot is
+// taken by a new one, and answers nearest, radius and k nearest queries under the
+// planner's metric. Any class with the same members can be swapped in through RRTStarN's
+// template parameters.
+
+/// @brief Keeps the k closest of the candidates offered to it, as a max heap on distance
+///        so the furthest one kept is the one to replace.
+template <typename T>
+class ClosestK{
+public:
+    ClosestK(size_t k) : m_k(k){
+        m_heap.reserve(k + 1);
+    }
+
+    /// @brief Distance a candidate must beat to be kept.
+    T bound() const{
+        return m_heap.size() < m_k ? std::numeric_limits<T>::max() : m_heap.front().first;
+    }
+
+    void offer(T distance, int index){
+        if(m_k == 0 || distance >= bound()){
+            return;
+        }
+        m_heap.push_back({distance, index});
+        std::push_heap(m_heap.begin(), m_heap.end());
+        if(m_heap.size() > m_k){
+            std::pop_heap(m_heap.begin(), m_heap.end());
+            m_heap.pop_back();
+        }
+    }
+
+    /// @brief Index of the furthest candidate kept, the closest when k is 1. -1 if none.
+    int furthest() const{
+        return m_heap.empty() ? -1 : m_heap.front().second;
+    }
+
+    /// @brief Fill out with the indices kept, closest first.
+    void result(std::vector<int>& out){
+        std::sort_heap(m_heap.begin(), m_heap.end());
+        out.clear();
+        for(const auto& [distance, index] : m_heap){
+            out.push_back(index);
+        }
+    }
+
+private:
+    size_t m_k;
+    std::vector<std::pair<T, int>> m_heap;
+};
+
+/// @brief Brute force scan of every state. Works with any metric, but each query costs
+///        O(n), so prefer KdTreeNearest where the metric allows.
+template <int D, typename T, typename Metric>
+class LinearNearest{
+public:
+    using State = VectorN<D, T>;
+
+    void clear(){
+        m_states.clear();
+        m_indices.clear();
+        m_position.clear();
+    }
+
+    /// @brief Store state as node index, an index not stored yet or one removed since.
+    void add(int index, const State& state){
+        if(size_t(index) >= m_position.size()){
+            m_position.resize(index + 1, -1);
+        }
+        m_position[index] = m_states.size();
+        m_states.push_back(state);
+        m_indices.push_back(index);
+    }
+
+    /// @brief Forget node index, moving the last state into its place.
+    void remove(int index){
+        int position = m_position[index];
+        m_states[position] = m_states.back();
+        m_indices[position] = m_indices.back();
+        m_position[m_indices[position]] = position;
+        m_states.pop_back();
+        m_indices.pop_back();
+        m_position[index] = -1;
+    }
+
+    size_t size() const{
+        return m_states.size();
+    }
+
+    /// @brief Index of the stored state closest to point, -1 if empty.
+    int nearest(const State& point) const{
+        T minDist = std::numeric_limits<T>::max();
+        int minIndex = -1;
+        for(size_t i = 0; i < m_states.size(); i++){
+            T dist = Metric::distance(point, m_states[i]);
+            if(dist < minDist){
+                minDist = dist;
+                minIndex = m_indices[i];
+            }
+        }
+        return minIndex;
+    }
+
+    /// @brief Fill out with the index of every stored state within radius of point.
+    void withinRadius(const State& point, T radius, std::vector<int>& out) const{
+        out.clear();
+        for(size_t i = 0; i < m_states.size(); i++){
+            if(Metric::distance(point, m_states[i]) <= radius){
+                out.push_back(m_indices[i]);
+            }
+        }
+    }
+
+    /// @brief Fill out with the indices of the k stored states closest to point, closest first.
+    void kNearest(const State& point, size_t k, std::vector<int>& out) const{
+        ClosestK<T> closest(k);
+        for(size_t i = 0; i < m_states.size(); i++){
+            closest.offer(Metric::distance(point, m_states[i]), m_indices[i]);
+        }
+        closest.result(out);
+    }
+
+private:
+    std::vector<State> m_states;   //< Packed, for the scans.
+    std::vector<int> m_indices;    //< Node index of each state.
+    std::vector<int> m_position;   //< Where each node index is in m_states, -1 if not stored.
+};
+
+/// @brief Kd-tree built one insertion at a time, splitting on each coordinate in turn. The
+///        planner's states arrive in random order, which keeps the tree's depth near
+///        O(log n), and so each query near O(log n) too. Removed states stay in the tree,
+///        skipped by queries, until they make up half of it and it is rebuilt balanced from
+///        the rest. Branches are pruned by the difference along the split coordinate, so
+///        this is for the Euclidean metric only.
+template <int D, typename T>
+class KdTreeNearest{
+public:
+    using State = VectorN<D, T>;
+
+    void clear(){
+        m_states.clear();
+        m_indices.clear();
+        m_children.clear();
+        m_removed.clear();
+        m_nodeOf.clear();
+        m_removedCount = 0;
+    }
+
+    /// @brief Store state as node index, an index not stored yet or one removed since.
+    void add(int index, const State& state){
+        if(size_t(index) >= m_nodeOf.size()){
+            m_nodeOf.resize(index + 1, -1);
+        }
+        m_nodeOf[index] = append(state, index);
+        int added = m_nodeOf[index];
+        if(added == 0){
+            return;
+        }
+
+        // Descend to the empty branch where the state belongs.
+        int node = 0;
+        for(int depth = 0; ; depth++){
+            int axis = depth % D;
+            int& next = m_children[node][state[axis] < m_states[node][axis] ? 0 : 1];
+            if(next == -1){
+                next = added;
+                return;
+            }
+            node = next;
+        }
+    }
+
+    /// @brief Forget node index.
+    void remove(int index){
+        m_removed[m_nodeOf[index]] = 1;
+        m_nodeOf[index] = -1;
+        m_removedCount++;
+        if(m_removedCount * 2 > m_states.size()){
+            rebuild();
+        }
+    }
+
+    size_t size() const{
+        return m_states.size() - m_removedCount;
+    }
+
+    /// @brief Index of the stored state closest to point, -1 if empty.
+    int nearest(const State& point) const{
+        ClosestK<T> closest(1);
+        search(root(), 0, point, closest);
+        return closest.furthest();
+    }
+
+    /// @brief Fill out with the index of every stored state within radius of point.
+    void withinRadius(const State& point, T radius, std::vector<int>& out) const{
+        out.clear();
+        T squared = radius * radius;
+        within(root(), 0, point, {radius, squared * (1 - RADIUS_SLACK), squared * (1 + RADIUS_SLACK)}, out);
+    }
+
+    /// @brief Fill out with the indices of the k stored states closest to point, closest first.
+    void kNearest(const State& point, size_t k, std::vector<int>& out) const{
+        ClosestK<T> closest(k);
+        search(root(), 0, point, closest);
+        closest.result(out);
+    }
+
+private:
+    // Per tree node, the root being node 0.
+    std::vector<State> m_states;
+    std::vector<int> m_indices;                 //< Planner node index each state is stored as.
+    std::vector<std::array<int, 2>> m_children; //< Below and at or above the split, -1 if none.
+    std::vector<char> m_removed;                //< Skipped by queries.
+
+    std::vector<int> m_nodeOf;                  //< Tree node of each planner node index, -1 if not stored.
+    size_t m_removedCount = 0;
+
+    int root() const{
+        return m_states.empty() ? -1 : 0;
+    }
+
+    int append(const State& state, int index){
+        m_states.push_back(state);
+        m_indices.push_back(index);
+        m_children.push_back({-1, -1});
+        m_removed.push_back(0);
+        return m_states.size() - 1;
+    }
+
+    // Rebuild from the states still stored, splitting each subtree at its median.
+    void rebuild(){
+        std::vector<State> states;
+        std::vector<int> indices;
+        for(size_t i = 0; i < m_states.size(); i++){
+            if(!m_removed[i]){
+                states.push_back(m_states[i]);
+                indices.push_back(m_indices[i]);
+            }
+        }
+        clear();
+        m_nodeOf.assign(indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1, -1);
+        std::vector<int> order(states.size());
+        for(size_t i = 0; i < order.size(); i++){
+            order[i] = i;
+        }
+        build(order.begin(), order.end(), 0, states, indices);
+    }
+
+    // Add the states at order[begin, end) as a subtree, returning its root. The median goes
+    // first so the root of the whole tree stays node 0.
+    int build(std::vector<int>::iterator begin, std::vector<int>::iterator end, int depth,
+              const std::vector<State>& states, const std::vector<int>& indices){
+        if(begin == end){
+            return -1;
+        }
+        int axis = depth % D;
+        auto median = begin + (end - begin) / 2;
+        std::nth_element(begin, median, end, [&](int a, int b){ return states[a][axis] < states[b][axis]; });
+        int node = append(states[*median], indices[*median]);
+        m_nodeOf[indices[*median]] = node;
+        int below = build(begin, median, depth + 1, states, indices);
+        int above = build(median + 1, end, depth + 1, states, indices);
+        m_children[node] = {below, above};
+        return node;
+    }
+
+    static T squaredDistance(const State& a, const State& b){
+        T sum = 0;
+        for(int i = 0; i < D; i++){
+            T d = a[i] - b[i];
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    // Offer every state under node to closest, skipping branches that cannot beat its bound.
+    // Distances are compared squared.
+    void search(int node, int depth, const State& point, ClosestK<T>& closest) const{
+        if(node == -1){
+            return;
+        }
+        const State& s = m_states[node];
+        if(!m_removed[node]){
+            closest.offer(squaredDistance(point, s), m_indices[node]);
+        }
+
+        T diff = point[depth % D] - s[depth % D];
+        search(m_children[node][diff < 0 ? 0 : 1], depth + 1, point, closest);
+        if(diff * diff < closest.bound()){
+            search(m_children[node][diff < 0 ? 1 : 0], depth + 1, point, closest);
+        }
+    }
+
+    // Squared distances further than this fraction from the squared radius are settled
+    // without a square root. Rounding radius * radius moves it far less.
+    static constexpr T RADIUS_SLACK = T(1e-5);
+
+    struct Radius{
+        T radius;
+        T inside;   //< Squared distances at most this are within the radius.
+        T outside;  //< Squared distances over this are not.
+    };
+
+    // A state is within the radius when its distance, computed as the Euclidean metric does,
+    // is at most the radius, so states exactly on the boundary agree with LinearNearest.
+    void within(int node, int depth, const State& point, const Radius& radius, std::vector<int>& out) const{
+        if(node == -1){
+            return;
+        }
+        const State& s = m_states[node];
+        if(!m_removed[node]){
+            T squared = squaredDistance(point, s);
+            if(squared <= radius.inside || (squared <= radius.outside && std::sqrt(squared) <= radius.radius)){
+                out.push_back(m_indices[node]);
+            }
+        }
+
+        T diff = point[depth % D] - s[depth % D];
+        within(m_children[node][diff < 0 ? 0 : 1], depth + 1, point, radius, out);
+        if(diff * diff <= radius.outside){
+            within(m_children[node][diff < 0 ? 1 : 0], depth + 1, point, radius, out);
+        }
+    }
+};
+
+#endif
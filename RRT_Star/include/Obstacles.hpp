@@ -1,103 +1,173 @@
+#ifndef OBSTACLES_HPP
+#define OBSTACLES_HPP
+
 #include <string>
 #include <vector>
-#include <fstream>
+#include <cstddef>
+#include <cstdint>
 
+#ifndef HEADLESS
 #if defined(LINUX) || defined(MINGW)
     #include <SDL2/SDL.h>
 #else // This works for Mac
     #include <SDL.h>
 #endif
+#endif
 
 #include "Math.hpp"
 #include "Polygon.hpp"
+#include "UniformGrid.hpp"
 
 class Obstacles{
 
 public:
 
-    Obstacles(std::string filename){
-        std::ifstream file;
+    /// @brief Load the obstacles from a file. The file may either be the text format
+    ///        described in the README, or the binary format written by saveBinary, which
+    ///        is recognized by its leading magic bytes.
+    /// @param filename Path to the obstacle file.
+    Obstacles(const std::string& filename);
+
+    /// @brief Build the obstacles from polygons already in memory, triangulating each one as
+    ///        the text loader does. The vertices are read straight from the caller's buffer.
+    /// @param xy Every polygon's vertices one after another, each as an x then a y.
+    /// @param counts Number of vertices in each polygon.
+    /// @param polygonCount Number of polygons.
+    Obstacles(const float* xy, const uint32_t* counts, size_t polygonCount);
+
+    /// @brief Write the obstacles, including their triangulations, to the binary format
+    ///        so later loads can skip parsing and triangulation entirely.
+    /// @param filename Path of the file to write.
+    void saveBinary(const std::string& filename) const;
+
+    /// @brief Split every polygon into convex pieces, see Polygon::DecomposeConvex. Collision
+    ///        tests then run against far fewer primitives than the triangulations have.
+    void decomposeConvex(){
+        for(Polygon& polygon : m_polygons){
+            polygon.DecomposeConvex();
+        }
+        buildBroadphase();
+    }
 
-        file.open(filename);
+    const std::vector<Polygon>& polygons() const{
+        return m_polygons;
+    }
 
-        if (!file.is_open()){
-            throw std::invalid_argument("Unable to open file.");
+#ifndef HEADLESS
+    /// @brief Outline every polygon, one SDL_RenderDrawLinesF call per polygon.
+    void draw(SDL_Renderer* renderer) const{
+        std::vector<SDL_FPoint> outline;
+        for(const Polygon& polygon: m_polygons){
+            drawPolygon(renderer, polygon.vertices, outline);
         }
+    }
+#endif
 
-        std::string line;
-        std::vector<Vector2f> temp;
-        while(getline(file, line)){
-            if (line.size() == 0){
-                m_polygons.push_back(Polygon(temp));
-                m_polygons.at(m_polygons.size()-1).TriangulateEarClipping();
-                temp.clear();
-            }else{
-                temp.push_back(parseVector(line));
-            }
+    bool inObstacles(const Vector2f& point) const{
+        return m_grid.anyAtPoint(point, [&](int shape){
+            return shapeContains(m_shapes[shape], point);
+        });
+    }
+
+    bool segmentInObstacles(const Vector2f& a, const Vector2f&b) const{
+        return m_grid.anyAlongSegment(a, b, [&](int shape){
+            return shapeContainsSegment(m_shapes[shape], a, b);
+        });
+    }
+
+    /// @brief Test if a disc of the given radius centered on point touches an obstacle.
+    bool inObstacles(const Vector2f& point, float radius) const{
+        if(radius <= 0){
+            return inObstacles(point);
         }
-        m_polygons.push_back(Polygon(temp));
-        m_polygons.at(m_polygons.size()-1).TriangulateEarClipping();
-    
-        file.close();
+        return m_grid.anyAlongSegment(point, point, [&](int shape){
+            return shapeNear(m_shapes[shape], point, point, radius);
+        }, radius);
+    }
+
+    /// @brief Test if a disc of the given radius touches an obstacle anywhere while its center
+    ///        moves from a to b.
+    bool segmentInObstacles(const Vector2f& a, const Vector2f& b, float radius) const{
+        if(radius <= 0){
+            return segmentInObstacles(a, b);
+        }
+        return m_grid.anyAlongSegment(a, b, [&](int shape){
+            return shapeNear(m_shapes[shape], a, b, radius);
+        }, radius);
+    }
+
+private:
+    std::vector<Polygon> m_polygons;
+
+    // The pieces collision queries test, each convex part of a decomposed polygon or else
+    // each triangle, with the grid bucketing their bounding boxes.
+    struct Shape{
+        int polygon;
+        int piece; //< Index into the polygon's convexParts if it has any, otherwise its triangles.
     };
+    std::vector<Shape> m_shapes;
+    UniformGrid m_grid;
+
+    // Rebuild the shapes and the grid, after loading or decomposing the polygons.
+    void buildBroadphase();
 
-    void draw(SDL_Renderer* renderer){
-        for(Polygon polygon: m_polygons){
-            drawPolygon(renderer, polygon.vertices);
+    bool shapeContains(const Shape& shape, const Vector2f& point) const{
+        const Polygon& polygon = m_polygons[shape.polygon];
+        if(!polygon.convexParts.empty()){
+            return PointInConvexPolygon(point, polygon.convexParts[shape.piece]);
         }
+        const Triangle& t = polygon.triangles[shape.piece];
+        return PointInTriangle(point, t[0], t[1], t[2]);
     }
 
-    bool inObstacles(const Vector2f& point){
-        for(Polygon polygon : m_polygons){
-            if (polygon.contains(point)){
-                return true;
-            }
+    bool shapeContainsSegment(const Shape& shape, const Vector2f& a, const Vector2f& b) const{
+        const Polygon& polygon = m_polygons[shape.polygon];
+        if(!polygon.convexParts.empty()){
+            return SegmentInConvexPolygon(a, b, polygon.convexParts[shape.piece]);
         }
-        return false;
+        return SegmentInTriangle(a, b, polygon.triangles[shape.piece]);
     }
 
-    bool segmentInObstacles(const Vector2f& a, const Vector2f&b){
-        for(Polygon polygon : m_polygons){
-            if (polygon.containsSegment(a,b)){
+    // True if the segment from a to b passes within radius of the shape.
+    bool shapeNear(const Shape& shape, const Vector2f& a, const Vector2f& b, float radius) const{
+        if(shapeContainsSegment(shape, a, b)){
+            return true;
+        }
+        const Polygon& polygon = m_polygons[shape.polygon];
+        const Vector2f* points = polygon.convexParts.empty() ? polygon.triangles[shape.piece].data()
+                                                             : polygon.convexParts[shape.piece].data();
+        size_t n = polygon.convexParts.empty() ? 3 : polygon.convexParts[shape.piece].size();
+        for(size_t i = 0; i < n; i++){
+            if(SegmentDistance(a, b, points[i], points[(i + 1) % n]) <= radius){
                 return true;
             }
         }
         return false;
     }
 
-private:
-    std::vector<Polygon> m_polygons;
-    
-    // Get a vector representation from a string listing x y coordinates seperated by a space.
-    Vector2f parseVector(const std::string s) {
-        int start = 0;
-        int end = 0;
-        std::string token;
-        std::vector<std::string> values;
-
-        while ((end = s.find(" ", start)) != std::string::npos) {
-            token = s.substr(start, end - start);
-            start = end + 1;
-            values.push_back (token);
-        }
+    // Parse the text format, one 'x y' vertex per line and an empty line between polygons,
+    // triangulating each polygon as it is completed.
+    void loadText(const char* data, size_t size);
 
-        values.push_back(s.substr(start));
-    
-        if(values.size() != 2){
-            throw std::invalid_argument("Malformed point definition. For each vertex specify as 'x y' on a single line.");
-        }
+    // Read the binary format, the vertices and triangle indices of each polygon are copied
+    // out of the file in bulk.
+    void loadBinary(const char* data, size_t size);
 
-        return {stof(values.at(0)), stof(values.at(1))};
-    }
-    
-    void drawPolygon(SDL_Renderer* renderer, const std::vector<Vector2f>& points){
-        for(size_t i = 0; i < points.size(); i++){
-            if(i == points.size() - 1){
-                SDL_RenderDrawLine(renderer, points.at(i).x, points.at(i).y, points.at(0).x, points.at(0).y);
-            }else{
-                SDL_RenderDrawLine(renderer, points.at(i).x, points.at(i).y, points.at(i + 1).x, points.at(i + 1).y);
-            }
+#ifndef HEADLESS
+    // Draw the closed outline of the points, reusing outline's storage between polygons.
+    static void drawPolygon(SDL_Renderer* renderer, const std::vector<Vector2f>& points, std::vector<SDL_FPoint>& outline){
+        if(points.empty()){
+            return;
         }
+        outline.clear();
+        for(const Vector2f& p : points){
+            outline.push_back({p.x, p.y});
+        }
+        outline.push_back({points[0].x, points[0].y});
+        SDL_RenderDrawLinesF(renderer, outline.data(), outline.size());
     }
+#endif
 
-};
\ No newline at end of file
+};
+
+#endif
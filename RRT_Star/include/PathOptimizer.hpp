@@ -0,0 +1,70 @@
+#ifndef PATH_OPTIMIZER_HPP
+#define PATH_OPTIMIZER_HPP
+
+#include "Math.hpp"
+#include "Obstacles.hpp"
+
+#include <random>
+#include <vector>
+
+/// @brief Costs and timing of one PathOptimizer::optimize run.
+struct OptimizationReport{
+    float costBefore = 0;        //< Length of the path as given.
+    float costShortcut = 0;      //< Length after both shortcutting passes.
+    float costAfter = 0;         //< Length of the final path.
+    size_t waypointsBefore = 0;
+    size_t waypointsAfter = 0;
+    double milliseconds = 0;     //< Time spent in optimize.
+};
+
+/// @brief Post processing for paths found by the planner, which zig-zag through a waypoint
+///        every rho or so. Shortcuts across the detours, then optionally rounds the corners.
+///        Every new edge is checked with Obstacles::segmentInObstacles, so the result stays
+///        collision free if the input path was.
+class PathOptimizer{
+public:
+
+    /// @param obs Obstacles the path must stay clear of.
+    /// @param radius Radius of the robot following the path, 0 for a point.
+    /// @param seed Seed for the randomized shortcutting.
+    PathOptimizer(const Obstacles& obs, float radius = 0, unsigned seed = std::random_device{}());
+
+    /// @brief Walk the path jumping ahead from each kept waypoint to a later one that is directly
+    ///        reachable, found with a doubling search followed by a binary search, so O(log n)
+    ///        segment checks per kept waypoint. The searches assume that waypoints stop being
+    ///        visible past some point, which obstacles need not respect, so this is a heuristic:
+    ///        a farther visible waypoint can be missed, and the result need not be the fewest
+    ///        waypoints. Every jump taken is checked, so it stays collision free.
+    std::vector<Vector2f> shortcutGreedy(const std::vector<Vector2f>& path) const;
+
+    /// @brief Try shortcuts between random points anywhere along the path, not only at
+    ///        waypoints, keeping each one that is collision free. Cuts corners the greedy
+    ///        pass has to leave in place.
+    /// @param attempts Number of shortcuts to try.
+    std::vector<Vector2f> shortcutRandom(std::vector<Vector2f> path, int attempts);
+
+    /// @brief Replace each edge with a centripetal Catmull-Rom spline through the waypoints,
+    ///        sampled into short segments. Edges whose spline would touch an obstacle stay
+    ///        straight.
+    /// @param samplesPerEdge Segments each curved edge is split into.
+    std::vector<Vector2f> smooth(const std::vector<Vector2f>& path, int samplesPerEdge = 8) const;
+
+    /// @brief Greedy then randomized shortcutting, then smoothing if asked for.
+    /// @param report If given, filled with the costs before and after.
+    std::vector<Vector2f> optimize(const std::vector<Vector2f>& path, bool smoothing = true,
+                                   int attempts = 200, OptimizationReport* report = nullptr);
+
+    /// @brief Total length of the path.
+    static float PathCost(const std::vector<Vector2f>& path);
+
+private:
+    const Obstacles* m_obs;
+    float m_radius;
+    std::mt19937 m_rng;
+
+    bool visible(const Vector2f& a, const Vector2f& b) const{
+        return !m_obs->segmentInObstacles(a, b, m_radius);
+    }
+};
+
+#endif
@@ -2,10 +2,11 @@
 #define POLYGON_HPP
 
 #include "Math.hpp"
+#include <array>
 #include <vector>
 #include <string>
 
-using Triangle = std::vector<Vector2f>;
+using Triangle = std::array<Vector2f, 3>;
 using Vertex = Vector2f;
 
 // Custom exception, contains functions will only be supported
@@ -13,8 +14,7 @@ using Vertex = Vector2f;
 class UnTriangulatedPolygon : public std::exception {
     public:
 const char * what () {
-    std::string message = "Does not support contains functionality for polygons that have not been triangulated. Please call TriangulateEarClipping first.";
-    return message.c_str();
+    return "Does not support contains functionality for polygons that have not been triangulated. Please call TriangulateEarClipping or TriangulateMonotone first.";
 }
 };
 
@@ -22,31 +22,51 @@ struct Polygon{
 
     Polygon(std::vector<Vertex> vertices);
 
+    /// @brief Construct an already triangulated polygon.
+    /// @param vertices Points at each vertex of the polygon.
+    /// @param triangleIndices Vertex indices of each triangle, three per triangle.
+    Polygon(std::vector<Vertex> vertices, std::vector<int> triangleIndices);
+
     std::vector<Vertex> vertices; //< List of points at each vertex of the polygon.
     std::vector<int> vertexIndices; //< List of 0 based indexing of each vertex.
     std::vector<Triangle> triangles; //< List of triangles if polygon is triangulated. Empty if not.
+    std::vector<int> triangleIndices; //< Vertex indices of each triangle, three per entry of triangles.
+    std::vector<std::vector<Vertex>> convexParts; //< Counter clockwise convex pieces if decomposed. Empty if not.
 
     /// @brief Use the ear clipping algorithm to triangulate a polygon. Assumes that
     ///        the prodvided polygon: contains no intersecting lines, colinear vertices
     ///        or cut out holes in the polygon. Stores the results in the triangles data member. 
     void TriangulateEarClipping();
 
+    /// @brief Triangulate in O(n log n) by sweeping the polygon into y-monotone pieces and
+    ///        triangulating each piece in linear time. Covers the same area as
+    ///        TriangulateEarClipping but handles polygons with hundreds of thousands of
+    ///        vertices. Accepts either winding order, same assumptions otherwise.
+    void TriangulateMonotone();
+
+    /// @brief Merge the triangles into convex pieces with the Hertel-Mehlhorn algorithm,
+    ///        dropping each diagonal whose removal leaves both of its end points convex.
+    ///        Uses at most four times the minimum number of convex pieces, usually far
+    ///        fewer than there are triangles. Once decomposed, contains and containsSegment
+    ///        test against the pieces instead of the triangles. Requires a triangulation.
+    void DecomposeConvex();
+
     /// @brief Test if the polygon contains some point.
     /// @param point The point to test.
     /// @return True if the point is inside or on the polygon.
-    bool contains(const Vector2f& point);
+    bool contains(const Vector2f& point) const;
 
     /// @brief Test if a line segment is contained in the polygon.
     /// @param a The first end point of the line segment.
     /// @param b The second end point of the line segment.
     /// @return True if the segment is at all contained in or on the polygon.
-    bool containsSegment(const Vector2f& a, const Vector2f& b);
+    bool containsSegment(const Vector2f& a, const Vector2f& b) const;
 };
 
 /// Helper function that will 'wrap-around' a data structure given a 
 /// provided index.
 template <typename T>
-int GetIndex(const std::vector<T> v, int index){
+int GetIndex(const std::vector<T>& v, int index){
     // Retrieve the size of our vector
     int len = v.size();
     // Most of the time, we'd hope to be within the bounds
@@ -0,0 +1,55 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include "Math.hpp"
+
+#include <cmath>
+#include <limits>
+
+// Exact orientation test for float points, after Shewchuk's adaptive predicates.
+// The determinant is first evaluated in float along with a bound on its rounding
+// error, which settles the sign for all but nearly collinear points. Only those
+// fall through to an exact evaluation. Relies on IEEE float arithmetic, so do not
+// build with -ffast-math.
+
+// Rounding error of a single float operation, 2^-24.
+constexpr float FLOAT_EPSILON = 0x1p-24f;
+
+// Bound on the error of the float determinant relative to the sum of the magnitudes
+// of its two products (Shewchuk's ccwerrboundA, for float).
+constexpr float ORIENT_ERROR_BOUND = (3.0f + 16.0f * FLOAT_EPSILON) * FLOAT_EPSILON;
+
+// Absolute slack for products that underflow, where the relative bound does not hold.
+constexpr float ORIENT_UNDERFLOW_BOUND = 4 * std::numeric_limits<float>::denorm_min();
+
+/// @brief Try to decide the orientation of a, b, c with float arithmetic alone. Branch free,
+///        so callers testing several orientations at once can settle them all before branching.
+/// @return +1 or -1 as Orient2D, or 0 when the points are too close to collinear for the
+///         float result to be trusted.
+inline int Orient2DFloatFilter(const Vector2f& a, const Vector2f& b, const Vector2f& c)
+{
+    float left = (b.x - a.x) * (c.y - a.y);
+    float right = (b.y - a.y) * (c.x - a.x);
+    float det = left - right;
+    float bound = ORIENT_ERROR_BOUND * (std::fabs(left) + std::fabs(right)) + ORIENT_UNDERFLOW_BOUND;
+    return (det > bound) - (det < -bound);
+}
+
+/// @brief Exact orientation of a, b, c without the float filter. Always correct but several
+///        times slower, Orient2D only falls back to it for nearly collinear points.
+/// @return +1 if c is left of the line a -> b, -1 if right, 0 if exactly collinear.
+int Orient2DExact(const Vector2f& a, const Vector2f& b, const Vector2f& c);
+
+/// @brief Exact orientation of a, b, c.
+/// @return +1 if c is left of the line a -> b (a, b, c counter clockwise), -1 if right
+///         (clockwise), 0 if exactly collinear.
+inline int Orient2D(const Vector2f& a, const Vector2f& b, const Vector2f& c)
+{
+    int sign = Orient2DFloatFilter(a, b, c);
+    if(sign != 0){
+        return sign;
+    }
+    return Orient2DExact(a, b, c);
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef QUAD_TREE_HPP
+#define QUAD_TREE_HPP
+
+#include "Math.hpp"
+#include "Obstacles.hpp"
+#include "UniformGrid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Occupancy of a rectangle of the workspace.
+enum class Occupancy : uint8_t{
+    FREE,   //< Entirely outside the obstacles.
+    FULL,   //< Entirely inside an obstacle.
+    MIXED   //< Crossed by an obstacle's boundary, or not known.
+};
+
+/// @brief Adaptive quadtree over the workspace, splitting only the cells an obstacle's boundary
+///        passes through. A cell the boundary misses is entirely inside or outside the
+///        obstacles, so it becomes a free or full leaf however large it is, and cells the
+///        boundary crosses are split down to the minimum size and left mixed. The tree's size
+///        therefore grows with the length of the boundaries rather than the workspace's area,
+///        which suits huge, mostly empty maps. Queries settled by free and full leaves never
+///        touch the polygons, the rest fall back to the exact tests of Obstacles.
+///        Read only once built, so any number of threads may query it at once.
+class OccupancyQuadTree{
+public:
+    /// @param obs Obstacles to classify the workspace against. Must outlive the tree.
+    /// @param lower Corner of the workspace with the smallest coordinates.
+    /// @param upper Corner of the workspace with the largest coordinates.
+    /// @param minCellSize Cells no larger than this on either side are not split further. Raised
+    ///        to at least 4e-5 times the largest absolute coordinate of the workspace, or 4e-5
+    ///        if that is below 1, since smaller cells are lost in float rounding.
+    /// @throws std::invalid_argument If minCellSize is not positive.
+    OccupancyQuadTree(const Obstacles& obs, const Vector2f& lower, const Vector2f& upper, float minCellSize);
+
+    /// @brief Occupancy of the leaf holding p, MIXED outside the workspace.
+    Occupancy occupancy(const Vector2f& p) const;
+
+    /// @brief FULL if a disc of the given radius moving from a to b touches a full leaf, FREE if
+    ///        it only touches free leaves, and otherwise MIXED, including when it leaves the
+    ///        workspace.
+    Occupancy occupancy(const Vector2f& a, const Vector2f& b, float radius = 0) const;
+
+    /// @brief Same answer as Obstacles::inObstacles, using the tree where it can.
+    bool inObstacles(const Vector2f& p, float radius = 0) const{
+        Occupancy o = radius > 0 ? occupancy(p, p, radius) : occupancy(p);
+        return o == Occupancy::MIXED ? m_obs->inObstacles(p, radius) : o == Occupancy::FULL;
+    }
+
+    /// @brief Same answer as Obstacles::segmentInObstacles, using the tree where it can.
+    bool segmentInObstacles(const Vector2f& a, const Vector2f& b, float radius = 0) const{
+        Occupancy o = occupancy(a, b, radius);
+        return o == Occupancy::MIXED ? m_obs->segmentInObstacles(a, b, radius) : o == Occupancy::FULL;
+    }
+
+    const Obstacles& obstacles() const{
+        return *m_obs;
+    }
+
+    /// @brief Nodes in the tree, counting both leaves and the cells they split from.
+    size_t nodeCount() const{
+        return m_nodes.size();
+    }
+
+    /// @brief Leaves of the given occupancy.
+    size_t leafCount(Occupancy occupancy) const;
+
+    /// @brief Bytes the tree's nodes take up.
+    size_t memoryBytes() const{
+        return m_nodes.capacity() * sizeof(Node);
+    }
+
+private:
+    // Four bytes per node: the index of the first of four consecutive children, or for a leaf,
+    // -1 less its occupancy.
+    struct Node{
+        int32_t value;
+
+        bool leaf() const{
+            return value < 0;
+        }
+
+        Occupancy occupancy() const{
+            return static_cast<Occupancy>(-1 - value);
+        }
+
+        static Node Leaf(Occupancy occupancy){
+            return {-1 - static_cast<int32_t>(occupancy)};
+        }
+    };
+
+    // A boundary edge of an obstacle.
+    struct Edge{
+        Vector2f a;
+        Vector2f b;
+    };
+
+    const Obstacles* m_obs;
+    Box m_bounds;
+    float m_minCellSize;
+    float m_epsilon;           //< Margin making classification err towards mixed under rounding.
+    std::vector<Node> m_nodes;
+
+    // Classify the node covering box among the edges that may cross it, splitting it if needed.
+    void build(int node, const Box& box, const std::vector<Edge>& edges);
+
+    // Visit the leaves under node that the disc moving from a to b may touch, setting mixed if
+    // one of them is mixed. Stops early, returning true, once it touches a full leaf.
+    bool collect(int node, const Box& box, const Vector2f& a, const Vector2f& b, float radius, bool& mixed) const;
+
+    // The quarter of box for child i: 0 and 1 are the low y half, 0 and 2 the low x half.
+    static Box quarter(const Box& box, int i){
+        float midX = 0.5f * (box.minX + box.maxX);
+        float midY = 0.5f * (box.minY + box.maxY);
+        return {i & 1 ? midX : box.minX, i & 2 ? midY : box.minY, i & 1 ? box.maxX : midX, i & 2 ? box.maxY : midY};
+    }
+};
+
+#endif
@@ -1,11 +1,30 @@
+#ifndef RRT_HPP
+#define RRT_HPP
+
 #include "Math.hpp"
 #include "Obstacles.hpp"
+#include "Metrics.hpp"
+#include "NearestNeighbors.hpp"
+#include "CollisionCheckers.hpp"
+#include "TreeDeltas.hpp"
+#ifndef HEADLESS
 #include "DrawUtils.hpp"
+#endif
 
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 #include <ctime>
-#include <cstdlib>
+#include <stop_token>
+#include <random>
 #include <iostream>
 #include <exception>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 // A custom exception for any config errors.
 class RRTStartConfigExcption : public std::exception {
@@ -17,97 +36,791 @@ const char * what () {
 }
 };
 
-/// @brief Node structure for storing auxillary information for each RRT* tree vertex.
-struct Node{
-    Vector2f vertex;             //< Point in space.
-    int parentIndex;             //< Index in RRT vector of the parent Node.
-    std::vector<int> children;   //< Indicies in RRT vector of children nodes. 
-    float cost;                  //< Distance traveled from start along each ancestor.
+/// @brief Where a search driven by step or runFor stands after a call returns.
+enum class PlanStatus{
+    RUNNING,   //< Iterations remain, call again to continue.
+    FINISHED,  //< The iteration budget is spent, or the first path was found when asked to stop there.
+    CANCELLED  //< The stop token was triggered. The search can still be resumed by calling again.
+};
+
+/// @brief Which tree nodes a new node considers as its parent and then rewires through.
+enum class NeighborhoodMode{
+    FIXED_RADIUS,     //< Every node within the neighborhood radius given to the constructor.
+    SHRINKING_RADIUS, //< Within gamma (log n / n)^(1/D) of the new node for a tree of n nodes,
+                      //  at most the neighborhood radius given to the constructor.
+    K_NEAREST         //< The k_RRT log n nodes closest to the new node.
 };
 
-class RRTStar{
+/// @brief RRT* over a D dimensional state space with scalar type T. The metric, nearest
+///        neighbor and collision backends are template parameters so every call in the
+///        main loop is resolved at compile time, see Metrics.hpp, NearestNeighbors.hpp
+///        and CollisionCheckers.hpp for what each must provide.
+template <int D,
+          typename T = float,
+          typename Metric = EuclideanMetric<D, T>,
+          typename Nearest = LinearNearest<D, T, Metric>,
+          typename Collision = ObstacleCollision<D, T>>
+class RRTStarN{
 public:
+    using State = VectorN<D, T>;
+
+    /// @brief Node structure for storing auxillary information for each RRT* tree vertex.
+    struct Node{
+        State vertex;                //< Point in space.
+        int parentIndex;             //< Index in RRT vector of the parent Node.
+        std::vector<int> children;   //< Indicies in RRT vector of children nodes. 
+        T cost;                      //< Distance traveled from start along each ancestor.
+        bool inTree;                 //< False once pruned, the slot then waits to be reused.
+    };
 
 /// @brief Construct an object to store and use for RRT* computation.
-/// @param xMax Max coordinate value in x direction of space.
-/// @param yMax Max coordinate value in y direction of space.
-/// @param obs Reference to the obstacles to test for collision.
+/// @param lower Min value of each coordinate of the state space.
+/// @param upper Max value of each coordinate of the state space.
+/// @param collision Backend to test states and motions for collision.
 /// @param start Point cooridnates to start search at.
 /// @param goal Point coorindates to center goal area in.
 /// @param goalRadius Radius from goal to consider completed goal.
-/// @param neighbordoodRadius Optional tuning parameter for neighborhood retrieval.
+/// @param neighbordoodRadius Optional tuning parameter for neighborhood retrieval, the largest
+///                           radius the neighborhood may have, see NeighborhoodMode.
 /// @param stepSizeRho Optional tuning parameter for sample step size from tree.
 /// @param maxIterations Optional tuning parameter for maximum iterations before algorithm reports
 ///                      goal notf found.
-RRTStar(int xMax, 
+RRTStarN(const State& lower,
+            const State& upper,
+            Collision collision,
+            const State& start,
+            const State& goal,
+            T goalRadius,
+            T neighbordoodRadius = 50,
+            T stepSizeRho = 30,
+            int maxIterations = 3000);
+
+/// @brief Construct a planner over the plane [0, xMax) x [0, yMax) avoiding obs.
+///        See the constructor above for the remaining parameters.
+RRTStarN(int xMax, 
             int yMax, 
             Obstacles& obs, 
-            const Vector2f& start, 
-            const Vector2f& goal, 
+            const State& start, 
+            const State& goal, 
             int goalRadius, 
             int neighbordoodRadius = 50, 
             int stepSizeRho = 30, 
-            int maxIterations = 3000);
+            int maxIterations = 3000) requires (D == 2 && std::is_constructible_v<Collision, Obstacles&>)
+    : RRTStarN(State(0, 0), State(xMax, yMax), Collision(obs), start, goal,
+               goalRadius, neighbordoodRadius, stepSizeRho, maxIterations){
+}
 
-/// @brief Find the best path from the set start to goal region.
+/// @brief Find the best path from the set start to goal region, stopping at the first one found.
 /// @return List of waypoints to travel between.
-std::vector<Vector2f> findBestPath();
+std::vector<State> findBestPath();
+
+/// @brief Start a new search, discarding any previous tree, to be run a bounded amount of work
+///        at a time with step or runFor, e.g. from a control loop with a fixed time per frame.
+/// @param stopAtFirstPath Finish as soon as the goal is first reached, as findBestPath does,
+///                        rather than spending the whole iteration budget shortening the path.
+void beginSearch(bool stopAtFirstPath = false);
+
+/// @brief Continue the search for up to the given number of iterations. Starts a search with
+///        beginSearch() first if none has been started.
+/// @param iterations Most iterations to run before returning.
+/// @param stop Checked every iteration, the search pauses once stop is requested.
+PlanStatus step(int iterations, std::stop_token stop = {}){
+    return run(iterations, std::chrono::steady_clock::time_point::max(), stop);
+}
+
+/// @brief Continue the search until budget has elapsed, checking the clock every iteration so
+///        it returns within about one iteration's time of it. Otherwise as step.
+template <typename Rep, typename Period>
+PlanStatus runFor(std::chrono::duration<Rep, Period> budget, std::stop_token stop = {}){
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+    return run(std::numeric_limits<int>::max(), deadline, stop);
+}
+
+/// @brief Best path found so far, waypoints from the goal back to the start. Empty if the goal
+///        has not been reached. Brought up to date whenever step or runFor returns.
+const std::vector<State>& bestPath() const{
+    return m_path;
+}
+
+/// @brief True once the search has reached the goal at least once.
+bool hasPath() const{
+    return !m_path.empty();
+}
+
+/// @brief Iterations run since the search began.
+int iterations() const{
+    return m_iteration;
+}
+
+#ifndef HEADLESS
+/// @brief Add the best path if found to the batch, projected onto the first two coordinates.
+void drawPath(GeometryBatch& batch) const;
+
+/// @brief Add the entire tree constructed in the process to the batch, projected onto the
+///        first two coordinates.
+void drawTree(GeometryBatch& batch) const;
+#endif
+
+/// @brief Report every change to the tree to log, see TreeDeltas.hpp, so another thread can
+///        follow the search as it runs. The log is written from whichever thread runs
+///        findBestPath. Pass nullptr to stop reporting.
+void setDeltaLog(TreeDeltaLog<State>* log){
+    m_deltaLog = log;
+}
+
+/// @brief Choose how neighborhoods are found, SHRINKING_RADIUS unless set. Either shrinking
+///        mode keeps the number of neighbors, and so the collision checks per iteration,
+///        growing only as log n while keeping RRT*'s asymptotic optimality. A fixed radius
+///        takes in ever more nodes as the tree grows denser. Takes effect from the next iteration.
+void setNeighborhoodMode(NeighborhoodMode mode){
+    config.neighborhoodMode = mode;
+}
+
+/// @brief Turn off, or back on, pruning the nodes that cannot lead to a better path than the
+///        best found: those whose cost to reach plus straight line distance on to the goal
+///        region is more than the best path's cost. Once a path exists the tree is pruned
+///        each time it has grown by a quarter since the last time. On by default. The slots
+///        of pruned nodes are reused by later ones.
+void setPruning(bool enabled){
+    config.pruning = enabled;
+}
+
+/// @brief Hold the tree to at most maxNodes nodes, 0 (the default) for no limit. A full tree
+///        is pruned, whether or not pruning is on, and if that frees too little, the leaves
+///        with the largest cost to reach plus distance to the goal are dropped, never the
+///        best path's. Memory then stays at the budget however long the search runs.
+void setNodeBudget(size_t maxNodes){
+    config.nodeBudget = maxNodes;
+}
+
+/// @brief Seed the random samples, which are otherwise seeded from the clock at construction,
+///        so planners made in the same second would sample alike.
+void setSeed(unsigned seed){
+    m_rng.seed(seed);
+}
+
+/// @brief Nodes in the tree now.
+size_t nodeCount() const{
+    return m_liveNodes;
+}
+
+/// @brief Node slots allocated, the nodes in the tree plus the slots of pruned ones waiting to
+///        be reused. Never more than the node budget, if set.
+size_t slotCount() const{
+    return m_tree.size();
+}
 
-/// @brief Draw to the renderer the best path if found.
-void drawPath(SDL_Renderer* renderer);
+/// @brief Radius of the neighborhood of the next node added in the radius modes.
+T neighborhoodRadius() const;
 
-/// @brief Draw the entire tree constructed in the process.
-void drawTree(SDL_Renderer* renderer);
+/// @brief Number of neighbors the next node added considers in K_NEAREST mode.
+size_t neighborhoodSize() const;
 
-/// @brief Retrieve the final cost of the path that was found.
-int getCost(){
+/// @brief Retrieve the cost of the best path found so far.
+T getCost() const{
     return m_pathCost;
 }
 
 private:
     
 std::vector<Node> m_tree;      //< Track the verticies of the tree.
-Vector2f m_start;              //< Starting location.
-Vector2f m_goal;               //< Goal region center.
-int m_goalRadius;              //< Radius of the goal region.
-Obstacles* m_obs;              //< Obstacles in the region.
-std::vector<Vector2f> m_path;  //< Retrieved path found.
-int m_pathCost = 0;            //< Cost of the path found.
+State m_start;                 //< Starting location.
+State m_goal;                  //< Goal region center.
+T m_goalRadius;                //< Radius of the goal region.
+Collision m_collision;         //< Obstacles in the region.
+Nearest m_nearest;             //< Index over the tree vertices for nearest and radius queries.
+std::vector<State> m_path;     //< Retrieved path found.
+T m_pathCost = 0;              //< Cost of the path found.
+std::mt19937 m_rng;            //< Source of the random samples.
+std::vector<int> m_neighbors;  //< Scratch list reused by every neighborhood query.
+TreeDeltaLog<State>* m_deltaLog = nullptr; //< Where changes to the tree are reported, if anywhere.
+std::vector<int> m_goalNodes;  //< Every node that reached the goal region.
+int m_bestGoalNode = -1;       //< The cheapest of them when the path was last brought up to date.
+int m_iteration = 0;           //< Iterations run in the current search.
+bool m_stopAtFirstPath = false; //< Finish the search as soon as the goal is reached.
+std::vector<int> m_freeSlots;  //< Slots of pruned nodes, taken before the tree grows.
+size_t m_liveNodes = 0;        //< Nodes in the tree, not counting free slots.
+size_t m_nodesAtLastPrune = 0; //< Nodes in the tree after it was last pruned.
 
 struct RRTStarConfig{
-    int xmax; //< Max value for x coordinates according to given state space
-    int ymax; //< Max value for y coordinates according to given state space
-    int neighborhoodRadius; //< Radius to aquire neighborhood of closest vertices
+    State lower; //< Min value of each coordinate according to given state space
+    State upper; //< Max value of each coordinate according to given state space
+    T neighborhoodRadius; //< Radius to aquire neighborhood of closest vertices
     int maxIterations; //< Maximum number of iterations to perfrom before reporting failure to find path.
-    int rho; //< Stepping size for steering function.
+    T rho; //< Stepping size for steering function.
+    NeighborhoodMode neighborhoodMode; //< How neighborhoods are found.
+    T gamma; //< Scale of the shrinking radius, just over the minimum keeping asymptotic optimality.
+    T kConstant; //< k_RRT, scale of the number of nearest neighbors, likewise.
+    bool pruning; //< Prune nodes that cannot improve the path found.
+    size_t nodeBudget; //< Most nodes the tree may hold, 0 for no limit.
 }config;
 
+// Run iterations until the count or deadline is reached, the search finishes or stop is requested.
+PlanStatus run(int iterations, std::chrono::steady_clock::time_point deadline, std::stop_token stop);
+
+// One iteration of RRT*, sample, steer, choose a parent and rewire.
+void iterate();
+
+// True once no more iterations should run.
+bool finished() const{
+    return m_iteration >= config.maxIterations || (m_stopAtFirstPath && !m_goalNodes.empty());
+}
+
+// Point the best path at the cheapest goal node. Rewiring keeps lowering their costs, so
+// which one is cheapest can change long after they were added.
+void updateBestPath();
+
 // Report if the provided point is in the goal region.
-bool reachedGoal(const Vector2f& point);
+bool reachedGoal(const State& point);
 
 // Retrieve the index of the nearest node in the tree based on the provided point.
-int findNearest(const Vector2f& point);
+int findNearest(const State& point);
 
-// Find the index of all nodes within the neighborhood radius of the provided point.
-std::vector<int> findNeighborhood(const Vector2f& point);
+// Find the index of all nodes in the neighborhood of the provided point, see NeighborhoodMode.
+const std::vector<int>& findNeighborhood(const State& point);
 
 // Choose the parent node based on which point in the neighborhood would lead to the new point 
 // with the lowest total cost.
-int chooseParentNode(const std::vector<int>& neighborhood, int nearest, const Vector2f& newPoint);
+int chooseParentNode(const std::vector<int>& neighborhood, int nearest, const State& newPoint);
 
 // Revise the tree by checking if any neighbors can be improved in cost by passing through the newly added point.
 void rewire(const std::vector<int>& neighborhood, int newPoint);
 
 //Choose a random coordinate in the free space.
-Vector2f freeRandomCoordinate();
+State freeRandomCoordinate();
 
 // Steer the random coordinate to a new coordinate within rho distance of the nearest point.
-Vector2f steer(const Vector2f& newPoint, const Vector2f& nearestPoint);
+State steer(const State& newPoint, const State& nearestPoint);
 
 // Update the cost of all children of this parent with the new cost of the parent plus the cost 
 // of the parent to the child.
 void updateChildrenCosts(const Node& parent);
 
+// Put a node in the tree below parent, in a free slot if there is one, and return its index.
+int addNode(const State& vertex, int parent, T cost);
+
+// Take node out of the tree along with every node below it, freeing their slots.
+void removeSubtree(int node);
+
+// Straight line distance from the state to the goal region, no more than any path's cost there.
+T costToGo(const State& state) const{
+    return std::max(T(0), Metric::distance(state, m_goal) - m_goalRadius);
+}
+
+// The goal node with the cheapest path so far, -1 if none.
+int cheapestGoalNode() const;
+
+// Remove the nodes that cannot lead to a path cheaper than the best, returning how many.
+size_t prune();
+
+// Bring the tree under its node budget, see setNodeBudget. Returns false if no room was made.
+bool makeRoom();
+
 // Reconstruct the final path found to the last node by tracing back throught the parents.
-std::vector<Vector2f> reconstructPath(const Node& last);
-};
\ No newline at end of file
+std::vector<State> reconstructPath(const Node& last);
+
+// Forward a change to the tree to the delta log, if one is set.
+void publish(typename TreeDelta<State>::Type type, int index, int parentIndex, const State& vertex = State()){
+    if(m_deltaLog != nullptr){
+        m_deltaLog->publish({type, index, parentIndex, vertex});
+    }
+}
+};
+
+/// The planar planner, compiled once in RRT.cpp, with a kd-tree indexing its nodes.
+using RRTStar = RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>>;
+
+/// Planners for (x, y, z) and for (x, y, z, heading) poses. The heading wraps around,
+/// which the kd-tree cannot prune by, so the 4D planner scans every node.
+using RRTStar3f = RRTStarN<3, float, EuclideanMetric<3, float>, KdTreeNearest<3, float>>;
+using RRTStar4f = RRTStarN<4, float, HeadingMetric<4, float>>;
+
+/// The planar planner for a disc shaped robot, see ClearanceCollision.
+using RRTStarDisc = RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>, ClearanceCollision<2, float>>;
+
+extern template class RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>>;
+extern template class RRTStarN<2, float, EuclideanMetric<2, float>, KdTreeNearest<2, float>, ClearanceCollision<2, float>>;
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+RRTStarN<D, T, Metric, Nearest, Collision>::RRTStarN(const State& lower,
+            const State& upper,
+            Collision collision,
+            const State& start,
+            const State& goal,
+            T goalRadius,
+            T neighbordoodRadius,
+            T stepSizeRho,
+            int maxIterations)
+    : m_collision(std::move(collision))
+{
+        // Set variables
+        config.lower = lower;
+        config.upper = upper;
+        config.neighborhoodRadius = neighbordoodRadius;
+        config.maxIterations = maxIterations;
+        config.rho = stepSizeRho;
+        config.neighborhoodMode = NeighborhoodMode::SHRINKING_RADIUS;
+        config.pruning = true;
+        config.nodeBudget = 0;
+        m_path = {};
+
+        // Karaman and Frazzoli's lower bounds for asymptotic optimality, gamma > 2 (1 + 1/d)^(1/d)
+        // (volume / unit ball volume)^(1/d) and k_RRT > e (1 + 1/d), raised by a tenth. The
+        // whole state space's volume stands in for the free space's, which only errs larger.
+        const T margin = 1.1;
+        T volume = 1;
+        for(int i = 0; i < D; i++){
+            volume *= upper[i] - lower[i];
+        }
+        T unitBall = std::pow(std::numbers::pi_v<T>, D / T(2)) / std::tgamma(D / T(2) + 1);
+        config.gamma = margin * 2 * std::pow((1 + T(1) / D) * volume / unitBall, T(1) / D);
+        config.kConstant = margin * std::numbers::e_v<T> * (1 + T(1) / D);
+
+        // Make sure the start is not in the obstacles
+        if(!m_collision.inCollision(start)){
+            m_start = start;
+        }else{
+            throw RRTStartConfigExcption("Cannot set start location within an obstacle.");
+        }
+
+        // Set goal either way, if it is in obstacle path will just not be found.
+        m_goal = goal;
+        m_goalRadius = goalRadius;
+        
+        // Seed the random number generation.
+        m_rng.seed(std::time(0));
+}
+
+#ifndef HEADLESS
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::drawPath(GeometryBatch& batch) const
+{
+    for(size_t i = 0; i < m_path.size(); i++){
+        if(i != m_path.size() - 1){
+            // Draw edge from point to next in path.
+            batch.addLine(m_path[i][0], m_path[i][1], m_path[i+1][0], m_path[i+1][1], {0,100,100,250});
+        }
+        batch.addPoint(m_path[i][0], m_path[i][1], {0,150,40,250}, 3);
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::drawTree(GeometryBatch& batch) const
+{
+    for(const Node& n : m_tree){
+        if(!n.inTree){
+            continue;
+        }
+        if(n.parentIndex != -1){
+            const Node& parent = m_tree[n.parentIndex];
+            batch.addLine(n.vertex[0], n.vertex[1], parent.vertex[0], parent.vertex[1], {240,240,240,70});
+        }
+        batch.addPoint(n.vertex[0], n.vertex[1], {230,230,230,70});
+    }
+}
+#endif
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+bool RRTStarN<D, T, Metric, Nearest, Collision>::reachedGoal(const State& point)
+{
+    return Metric::distance(point, m_goal) <= m_goalRadius;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+std::vector<typename RRTStarN<D, T, Metric, Nearest, Collision>::State>
+RRTStarN<D, T, Metric, Nearest, Collision>::reconstructPath(const Node& last)
+{
+    std::vector<State> path;
+    path.push_back(last.vertex);
+    int p = last.parentIndex;
+
+    while(p != -1){
+        path.push_back(m_tree.at(p).vertex);
+        p = m_tree.at(p).parentIndex;
+    }
+    return path;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+std::vector<typename RRTStarN<D, T, Metric, Nearest, Collision>::State>
+RRTStarN<D, T, Metric, Nearest, Collision>::findBestPath()
+{
+    beginSearch(true);
+    step(config.maxIterations);
+    return m_path;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::beginSearch(bool stopAtFirstPath)
+{
+    // reset tree in case running multiple times
+    m_tree.clear();
+    m_nearest.clear();
+    m_path.clear();
+    m_pathCost = 0;
+    m_goalNodes.clear();
+    m_bestGoalNode = -1;
+    m_iteration = 0;
+    m_stopAtFirstPath = stopAtFirstPath;
+    m_freeSlots.clear();
+    m_liveNodes = 0;
+    m_nodesAtLastPrune = 0;
+
+    // add start vertex to tree
+    publish(TreeDelta<State>::Type::RESET, -1, -1);
+    addNode(m_start, -1, 0);
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+PlanStatus RRTStarN<D, T, Metric, Nearest, Collision>::run(int iterations, std::chrono::steady_clock::time_point deadline, std::stop_token stop)
+{
+    if(m_tree.empty()){
+        beginSearch();
+    }
+
+    PlanStatus status = PlanStatus::RUNNING;
+    for(int i = 0; i < iterations; i++){
+        if(finished()){
+            break;
+        }
+        if(stop.stop_requested()){
+            status = PlanStatus::CANCELLED;
+            break;
+        }
+        // Only read the clock when there is a deadline to meet.
+        if(deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline){
+            break;
+        }
+        iterate();
+    }
+
+    updateBestPath();
+    if(status != PlanStatus::CANCELLED && finished()){
+        status = PlanStatus::FINISHED;
+    }
+    return status;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::iterate()
+{
+    m_iteration++;
+
+    // Drop nodes that can no longer help before the tree grows much further, and keep it
+    // within its budget. Done before anything is picked from the tree for this iteration.
+    if(config.pruning && !m_goalNodes.empty() && m_liveNodes >= m_nodesAtLastPrune + m_nodesAtLastPrune / 4){
+        prune();
+    }
+    if(config.nodeBudget != 0 && m_liveNodes >= config.nodeBudget && !makeRoom()){
+        return;
+    }
+
+    // Find a new cooridnate to try from random sample the steering towards the 
+    // nearest coordinate in the tree to a new point.
+    State randSample = freeRandomCoordinate();
+    int nearest = findNearest(randSample);
+    State newPoint = steer(randSample, m_tree.at(nearest).vertex);
+
+    // Ensure that the new point is not in an obstacle, otherwise try again
+    // in next iteration
+    if(m_collision.inCollision(newPoint)){
+        return;
+    }
+
+    // Get the neighborhood and choose the best cost parent form it 
+    // for the new point.
+    const std::vector<int>& neighbors = findNeighborhood(newPoint);
+    int parent = chooseParentNode(neighbors, nearest, newPoint);
+
+    if(parent == -1){
+        //skipping iteration, only could find paths through obstacles
+        return;
+    }
+
+    // Add the new index to the tree via the chosen parent
+    int newIndex = addNode(newPoint, parent, m_tree.at(parent).cost + Metric::distance(m_tree.at(parent).vertex, newPoint));
+
+    // Rewire the tree to check for shorter cost paths
+    rewire(neighbors, newIndex);
+
+    // Remember nodes that made it to the goal region, the best path ends at one of them.
+    if(reachedGoal(newPoint)){
+        m_goalNodes.push_back(newIndex);
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+int RRTStarN<D, T, Metric, Nearest, Collision>::addNode(const State& vertex, int parent, T cost)
+{
+    int index;
+    if(!m_freeSlots.empty()){
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_tree[index] = {vertex, parent, {}, cost, true};
+    }else{
+        index = m_tree.size();
+        m_tree.push_back({vertex, parent, {}, cost, true});
+    }
+    if(parent != -1){
+        m_tree[parent].children.push_back(index);
+    }
+    m_nearest.add(index, vertex);
+    m_liveNodes++;
+    publish(TreeDelta<State>::Type::ADD, index, parent, vertex);
+    return index;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::removeSubtree(int node)
+{
+    if(m_tree[node].parentIndex != -1){
+        std::vector<int>& siblings = m_tree[m_tree[node].parentIndex].children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), node), siblings.end());
+    }
+
+    std::vector<int> pending = {node};
+    while(!pending.empty()){
+        int i = pending.back();
+        pending.pop_back();
+        Node& n = m_tree[i];
+        pending.insert(pending.end(), n.children.begin(), n.children.end());
+
+        n.inTree = false;
+        std::vector<int>().swap(n.children);
+        m_nearest.remove(i);
+        m_freeSlots.push_back(i);
+        m_liveNodes--;
+        if(i == m_bestGoalNode){
+            m_bestGoalNode = -1;
+        }
+        publish(TreeDelta<State>::Type::REMOVE, i, -1);
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+int RRTStarN<D, T, Metric, Nearest, Collision>::cheapestGoalNode() const
+{
+    int best = -1;
+    for(int g : m_goalNodes){
+        if(best == -1 || m_tree.at(g).cost < m_tree.at(best).cost){
+            best = g;
+        }
+    }
+    return best;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+size_t RRTStarN<D, T, Metric, Nearest, Collision>::prune()
+{
+    size_t before = m_liveNodes;
+    int best = cheapestGoalNode();
+    if(best != -1){
+        // The best path's own nodes are kept outright, rounding could otherwise put one a hair
+        // over the bound it sets.
+        std::vector<char> onPath(m_tree.size(), 0);
+        for(int i = best; i != -1; i = m_tree[i].parentIndex){
+            onPath[i] = 1;
+        }
+
+        T bound = m_tree[best].cost;
+        for(size_t i = 1; i < m_tree.size(); i++){
+            const Node& n = m_tree[i];
+            if(n.inTree && !onPath[i] && n.cost + costToGo(n.vertex) > bound){
+                removeSubtree(i);
+            }
+        }
+        std::erase_if(m_goalNodes, [&](int g){ return !m_tree[g].inTree; });
+    }
+    m_nodesAtLastPrune = m_liveNodes;
+    return before - m_liveNodes;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+bool RRTStarN<D, T, Metric, Nearest, Collision>::makeRoom()
+{
+    // Free a sixteenth of the budget at a time so this runs rarely.
+    size_t target = config.nodeBudget - std::max<size_t>(1, config.nodeBudget / 16);
+    prune();
+    if(m_liveNodes <= target){
+        return true;
+    }
+
+    // Still full, drop the least promising leaves.
+    std::vector<char> onPath(m_tree.size(), 0);
+    for(int i = cheapestGoalNode(); i != -1; i = m_tree[i].parentIndex){
+        onPath[i] = 1;
+    }
+    std::vector<std::pair<T, int>> leaves;
+    for(size_t i = 1; i < m_tree.size(); i++){
+        const Node& n = m_tree[i];
+        if(n.inTree && n.children.empty() && !onPath[i]){
+            leaves.push_back({n.cost + costToGo(n.vertex), int(i)});
+        }
+    }
+    size_t count = std::min(leaves.size(), m_liveNodes - target);
+    std::nth_element(leaves.begin(), leaves.begin() + count, leaves.end(), std::greater<>());
+    for(size_t k = 0; k < count; k++){
+        removeSubtree(leaves[k].second);
+    }
+    std::erase_if(m_goalNodes, [&](int g){ return !m_tree[g].inTree; });
+    m_nodesAtLastPrune = m_liveNodes;
+    return m_liveNodes < config.nodeBudget;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::updateBestPath()
+{
+    int best = cheapestGoalNode();
+    if(best == -1){
+        return;
+    }
+
+    if(best != m_bestGoalNode || m_tree.at(best).cost != m_pathCost){
+        m_path = reconstructPath(m_tree.at(best));
+        m_pathCost = m_tree.at(best).cost;
+    }
+    if(best != m_bestGoalNode){
+        publish(TreeDelta<State>::Type::PATH, best, m_tree.at(best).parentIndex);
+        m_bestGoalNode = best;
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+typename RRTStarN<D, T, Metric, Nearest, Collision>::State
+RRTStarN<D, T, Metric, Nearest, Collision>::steer(const State& randPoint, const State& nearestPoint)
+{
+    T dist = Metric::distance(randPoint, nearestPoint);
+
+    // check if the random point is already close enough
+    if(dist <= config.rho){
+        return randPoint;
+    }else{
+        // If not close enough take a step of length rho in the direction of the random point.
+        return Metric::interpolate(nearestPoint, randPoint, config.rho / dist);
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+int RRTStarN<D, T, Metric, Nearest, Collision>::chooseParentNode(const std::vector<int>& neighborhood, int nearest, const State& newPoint)
+{
+    // Start with the nearest node as best partent index
+    int bestParent = nearest;
+
+    // Using the cost to reach the node, plus the distance from this node to the new point
+    T bestCost = m_tree.at(nearest).cost + Metric::distance(m_tree.at(nearest).vertex, newPoint);
+
+    // Check against all the neigbors to find the best path parent
+    for(int nIndex : neighborhood){
+        const Node& n = m_tree.at(nIndex);
+        T cost = n.cost + Metric::distance(n.vertex, newPoint);
+
+        // Found a better parent if the cost to the parent plus the cost
+        // to the new point is less than the best found so far AND
+        // there is no obsatcle obstructing the path to the new point
+        if(cost < bestCost && !m_collision.segmentInCollision(n.vertex, newPoint)){
+            bestParent = nIndex;
+            bestCost = cost;
+        }
+    }
+
+    // special check if the nearest node was chosen and there is an obstacle in the way, need
+    // to indacate this point cannot be used
+    if(bestParent == nearest && m_collision.segmentInCollision(m_tree.at(bestParent).vertex, newPoint)){
+        return -1;
+    }
+
+    return bestParent;
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::rewire(const std::vector<int>& neighborhood, int newPoint)
+{
+    for(int nIndex : neighborhood){
+        Node& n = m_tree.at(nIndex);
+        T cost = m_tree.at(newPoint).cost + Metric::distance(m_tree.at(newPoint).vertex, n.vertex);
+
+        // If cost to new point plus distance from new point to neighbor is less than the 
+        // neighbors current cost ...
+        // AND there are no obstacles between the new vertex and the neighbor
+        if(cost < n.cost && !m_collision.segmentInCollision(n.vertex, m_tree.at(newPoint).vertex)){
+
+            // Remove this node from its parents children list
+            std::vector<int>& children = m_tree.at(n.parentIndex).children;
+            children.erase(std::remove(children.begin(), children.end(), nIndex), children.end());
+
+            // Update the new cost and parent index
+            n.cost = cost;
+            n.parentIndex = newPoint;
+            publish(TreeDelta<State>::Type::REWIRE, nIndex, newPoint);
+
+            // Add as a child to the new parent
+            m_tree.at(newPoint).children.push_back(nIndex);
+
+            // Recursively update any children costs with the new connection cost
+            updateChildrenCosts(n);
+        }
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+void RRTStarN<D, T, Metric, Nearest, Collision>::updateChildrenCosts(const Node& parent)
+{
+    for(int childIndex : parent.children){
+        m_tree.at(childIndex).cost = parent.cost + Metric::distance(parent.vertex, m_tree.at(childIndex).vertex);
+        updateChildrenCosts(m_tree.at(childIndex));
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+int RRTStarN<D, T, Metric, Nearest, Collision>::findNearest(const State& point)
+{
+    return m_nearest.nearest(point);
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+typename RRTStarN<D, T, Metric, Nearest, Collision>::State
+RRTStarN<D, T, Metric, Nearest, Collision>::freeRandomCoordinate()
+{
+    while(true){
+        State p;
+        for(int i = 0; i < D; i++){
+            std::uniform_real_distribution<T> axis(config.lower[i], config.upper[i]);
+            p[i] = axis(m_rng);
+        }
+
+        if(!m_collision.inCollision(p)){
+            return p;
+        }
+    }
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+T RRTStarN<D, T, Metric, Nearest, Collision>::neighborhoodRadius() const
+{
+    if(config.neighborhoodMode != NeighborhoodMode::SHRINKING_RADIUS){
+        return config.neighborhoodRadius;
+    }
+    // Counting the node about to be added.
+    T n = m_liveNodes + 1;
+    return std::min(config.neighborhoodRadius, config.gamma * std::pow(std::log(n) / n, T(1) / D));
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+size_t RRTStarN<D, T, Metric, Nearest, Collision>::neighborhoodSize() const
+{
+    T n = m_liveNodes + 1;
+    return static_cast<size_t>(std::ceil(config.kConstant * std::log(n)));
+}
+
+template <int D, typename T, typename Metric, typename Nearest, typename Collision>
+const std::vector<int>& RRTStarN<D, T, Metric, Nearest, Collision>::findNeighborhood(const State& point)
+{
+    if(config.neighborhoodMode == NeighborhoodMode::K_NEAREST){
+        m_nearest.kNearest(point, neighborhoodSize(), m_neighbors);
+    }else{
+        m_nearest.withinRadius(point, neighborhoodRadius(), m_neighbors);
+    }
+    return m_neighbors;
+}
+
+#endif
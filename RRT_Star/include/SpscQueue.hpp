@@ -0,0 +1,68 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/// @brief Bounded lock free queue for exactly one producer thread and one consumer thread.
+///        Neither side ever waits on the other, tryPush fails when the queue is full and
+///        tryPop when it is empty.
+template <typename T>
+class SpscQueue{
+public:
+    /// @param capacity Number of slots, rounded up to a power of two.
+    explicit SpscQueue(size_t capacity){
+        size_t size = 1;
+        while(size < capacity){
+            size *= 2;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// @brief Producer only. Copy value into the queue unless it is full.
+    bool tryPush(const T& value){
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_cachedHead == m_slots.size()){
+            // Looks full, see how far the consumer has got since we last checked.
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if(tail - m_cachedHead == m_slots.size()){
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Consumer only. Move the oldest value into value unless the queue is empty.
+    bool tryPop(T& value){
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_cachedTail){
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if(head == m_cachedTail){
+                return false;
+            }
+        }
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask;
+
+    // Each side's index and its cached copy of the other side's sit on their own cache
+    // lines, so the threads only share a line when a cached copy has to be refreshed.
+    alignas(64) std::atomic<size_t> m_head{0};  //< Next slot to pop, written by the consumer.
+    alignas(64) size_t m_cachedTail = 0;        //< Consumer's last view of m_tail.
+    alignas(64) std::atomic<size_t> m_tail{0};  //< Next slot to push, written by the producer.
+    alignas(64) size_t m_cachedHead = 0;        //< Producer's last view of m_head.
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef TREE_DELTAS_HPP
+#define TREE_DELTAS_HPP
+
+#include "SpscQueue.hpp"
+#ifndef HEADLESS
+#include "DrawUtils.hpp"
+#endif
+
+#include <deque>
+#include <vector>
+
+// A planner running on another thread reports each change to its tree as a TreeDelta.
+// The planner's thread publishes them through a TreeDeltaLog and the viewer's thread
+// replays them into a TreeMirror, so the viewer always holds a consistent copy of the
+// tree as of some point in the run without ever locking the planner's own.
+
+template <typename State>
+struct TreeDelta{
+    enum class Type{
+        RESET,   //< The tree was cleared for a new search.
+        ADD,     //< Node index was added at vertex below parentIndex (-1 for the root), either
+                 //  as the next index or in the slot of a removed node.
+        REWIRE,  //< Node index moved below parentIndex.
+        REMOVE,  //< Node index was pruned from the tree, its slot may be reused by a later ADD.
+        PATH,    //< The best path now ends at node index.
+        DONE     //< The planner finished, no more deltas follow.
+    };
+
+    Type type;
+    int index;
+    int parentIndex;
+    State vertex;
+};
+
+/// @brief Producer end of the delta stream. Deltas that do not fit in the queue because the
+///        consumer has fallen behind are held back in order and sent later, so publishing
+///        never blocks and nothing is lost.
+template <typename State>
+class TreeDeltaLog{
+public:
+    using Delta = TreeDelta<State>;
+
+    TreeDeltaLog(SpscQueue<Delta>& queue) : m_queue(queue){
+    }
+
+    void publish(const Delta& delta){
+        if(!m_pending.empty() && !flush()){
+            m_pending.push_back(delta);
+            return;
+        }
+        if(!m_queue.tryPush(delta)){
+            m_pending.push_back(delta);
+        }
+    }
+
+    /// @brief Send as many held back deltas as fit, true once none are left.
+    bool flush(){
+        while(!m_pending.empty()){
+            if(!m_queue.tryPush(m_pending.front())){
+                return false;
+            }
+            m_pending.pop_front();
+        }
+        return true;
+    }
+
+private:
+    SpscQueue<Delta>& m_queue;
+    std::deque<Delta> m_pending;
+};
+
+/// @brief Consumer end of the delta stream, a copy of the planner's tree built by replaying it.
+template <typename State>
+class TreeMirror{
+public:
+    using Delta = TreeDelta<State>;
+
+    /// @brief Apply every delta currently in the queue.
+    /// @return True if anything changed.
+    bool drain(SpscQueue<Delta>& queue){
+        bool changed = false;
+        Delta delta;
+        while(queue.tryPop(delta)){
+            apply(delta);
+            changed = true;
+        }
+        return changed;
+    }
+
+    size_t size() const{
+        return m_vertices.size();
+    }
+
+    /// @brief True once the planner has reported that it finished.
+    bool done() const{
+        return m_done;
+    }
+
+    /// @brief True if edges already drawn may have moved since the last clearRestructured,
+    ///        because of a rewire, a removal or a reset, or a node was added in a reused
+    ///        slot, so only drawing the nodes past the last one drawn is not enough.
+    bool restructured() const{
+        return m_restructured;
+    }
+
+    void clearRestructured(){
+        m_restructured = false;
+    }
+
+#ifndef HEADLESS
+    /// @brief Add the nodes from index first on, and the edges to their parents, to the batch.
+    void drawNodes(GeometryBatch& batch, size_t first) const{
+        for(size_t i = first; i < m_vertices.size(); i++){
+            if(!m_inTree[i]){
+                continue;
+            }
+            const State& v = m_vertices[i];
+            if(m_parents[i] != -1){
+                const State& parent = m_vertices[m_parents[i]];
+                batch.addLine(v[0], v[1], parent[0], parent[1], {240,240,240,70});
+            }
+            batch.addPoint(v[0], v[1], {230,230,230,70});
+        }
+    }
+
+    /// @brief Add the best path so far, if any, to the batch.
+    void drawPath(GeometryBatch& batch) const{
+        for(int i = m_pathEnd; i != -1; i = m_parents[i]){
+            const State& v = m_vertices[i];
+            if(m_parents[i] != -1){
+                const State& next = m_vertices[m_parents[i]];
+                batch.addLine(v[0], v[1], next[0], next[1], {0,100,100,250});
+            }
+            batch.addPoint(v[0], v[1], {0,150,40,250}, 3);
+        }
+    }
+#endif
+
+private:
+    std::vector<State> m_vertices;
+    std::vector<int> m_parents;
+    std::vector<char> m_inTree;
+    int m_pathEnd = -1;
+    bool m_done = false;
+    bool m_restructured = false;
+
+    void apply(const Delta& delta){
+        switch(delta.type){
+        case Delta::Type::RESET:
+            m_vertices.clear();
+            m_parents.clear();
+            m_inTree.clear();
+            m_pathEnd = -1;
+            m_done = false;
+            m_restructured = true;
+            break;
+        case Delta::Type::ADD:
+            if(size_t(delta.index) < m_vertices.size()){
+                m_vertices[delta.index] = delta.vertex;
+                m_parents[delta.index] = delta.parentIndex;
+                m_inTree[delta.index] = 1;
+                m_restructured = true;
+            }else{
+                m_vertices.push_back(delta.vertex);
+                m_parents.push_back(delta.parentIndex);
+                m_inTree.push_back(1);
+            }
+            break;
+        case Delta::Type::REMOVE:
+            m_inTree[delta.index] = 0;
+            if(m_pathEnd == delta.index){
+                m_pathEnd = -1;
+            }
+            m_restructured = true;
+            break;
+        case Delta::Type::REWIRE:
+            m_parents[delta.index] = delta.parentIndex;
+            m_restructured = true;
+            break;
+        case Delta::Type::PATH:
+            m_pathEnd = delta.index;
+            break;
+        case Delta::Type::DONE:
+            m_done = true;
+            break;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef UNIFORM_GRID_HPP
+#define UNIFORM_GRID_HPP
+
+#include "Math.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/// @brief Axis aligned bounding box.
+struct Box{
+    float minX, minY, maxX, maxY;
+
+    bool overlaps(const Box& other) const{
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+
+    bool contains(const Vector2f& p) const{
+        return minX <= p.x && p.x <= maxX && minY <= p.y && p.y <= maxY;
+    }
+
+    static Box Around(const std::vector<Vector2f>& points);
+};
+
+/// @brief Broadphase for collision queries. Buckets the bounding boxes of a set of shapes into
+///        a uniform grid of square cells, so a point or segment query only runs the exact test
+///        on shapes whose boxes share a cell with it and overlap its own box. Read only once
+///        built, so any number of threads may query it at once.
+class UniformGrid{
+public:
+    /// @brief Bucket the boxes, shape i being boxes[i]. Picks a cell size giving a few cells
+    ///        per shape over the area the boxes cover.
+    void build(const std::vector<Box>& boxes);
+
+    /// @brief Call test(i) for each shape i whose box contains p, until one returns true.
+    /// @return True if a test returned true.
+    template <typename Test>
+    bool anyAtPoint(const Vector2f& p, Test test) const{
+        if(m_items.empty() || !m_bounds.contains(p)){
+            return false;
+        }
+        int cell = row(p.y) * m_cols + column(p.x);
+        for(int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++){
+            int i = m_cellItems[k];
+            if(m_items[i].box.contains(p) && test(i)){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Call test(i) once for each shape i whose box may be crossed by the segment from
+    ///        a to b, until one returns true. Cells are visited row by row along the segment,
+    ///        padded so rounding can only add cells, never skip one.
+    /// @param radius Also visit shapes within this distance of the segment, for a disc
+    ///               moving along it.
+    /// @return True if a test returned true.
+    template <typename Test>
+    bool anyAlongSegment(const Vector2f& a, const Vector2f& b, Test test, float radius = 0) const{
+        Box segment = {std::min(a.x, b.x) - radius, std::min(a.y, b.y) - radius,
+                       std::max(a.x, b.x) + radius, std::max(a.y, b.y) + radius};
+        if(m_items.empty() || !m_bounds.overlaps(segment)){
+            return false;
+        }
+
+        int firstRow = row(segment.minY);
+        int lastRow = row(segment.maxY);
+        float pad = m_cellSize * 1e-4f + radius;
+        int previousFirst = 0;  //< Columns visited in the previous row, empty if last < first.
+        int previousLast = -1;
+
+        for(int r = firstRow; r <= lastRow; r++){
+            // Part of the segment inside this row of cells, widened by the radius and a little more.
+            float bandLow = std::max(segment.minY, m_bounds.minY + r * m_cellSize - pad);
+            float bandHigh = std::min(segment.maxY, m_bounds.minY + (r + 1) * m_cellSize + pad);
+            float xLow = segment.minX;
+            float xHigh = segment.maxX;
+            if(a.y != b.y){
+                float x1 = a.x + (bandLow - a.y) * (b.x - a.x) / (b.y - a.y);
+                float x2 = a.x + (bandHigh - a.y) * (b.x - a.x) / (b.y - a.y);
+                xLow = std::max(xLow, std::min(x1, x2) - pad);
+                xHigh = std::min(xHigh, std::max(x1, x2) + pad);
+            }
+            int first = column(xLow);
+            int last = column(xHigh);
+            if(xLow > xHigh){
+                previousFirst = 0;
+                previousLast = -1;
+                continue;
+            }
+
+            for(int c = first; c <= last; c++){
+                int cell = r * m_cols + c;
+                for(int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++){
+                    int i = m_cellItems[k];
+                    const Item& item = m_items[i];
+
+                    // The cells visited in consecutive rows overlap, so a shape is only tested
+                    // in the first visited cell listing it: the leftmost one in this row, and
+                    // only if the previous row did not already reach it.
+                    if(c != std::max(first, item.firstColumn)){
+                        continue;
+                    }
+                    if(r > firstRow && r > item.firstRow && previousFirst <= previousLast
+                       && previousFirst <= item.lastColumn && previousLast >= item.firstColumn){
+                        continue;
+                    }
+                    if(item.box.overlaps(segment) && test(i)){
+                        return true;
+                    }
+                }
+            }
+            previousFirst = first;
+            previousLast = last;
+        }
+        return false;
+    }
+
+private:
+    struct Item{
+        Box box;
+        int firstColumn, lastColumn, firstRow, lastRow;
+    };
+
+    Box m_bounds = {0, 0, 0, 0};
+    float m_cellSize = 1;
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<Item> m_items;
+    std::vector<int> m_cellStart;  //< Items of cell i are m_cellItems[m_cellStart[i] .. m_cellStart[i + 1]).
+    std::vector<int> m_cellItems;
+
+    int column(float x) const{
+        return std::clamp(int((x - m_bounds.minX) / m_cellSize), 0, m_cols - 1);
+    }
+
+    int row(float y) const{
+        return std::clamp(int((y - m_bounds.minY) / m_cellSize), 0, m_rows - 1);
+    }
+};
+
+#endif
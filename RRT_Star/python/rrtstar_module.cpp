@@ -0,0 +1,652 @@
+// Python bindings for the obstacles and the planner, written against the CPython and NumPy
+// C APIs so they need nothing beyond NumPy to build. See the README for the Python side.
+//
+// Arrays of points are (n, 2) float32 arrays. Ones that are already float32 and C contiguous
+// are read in place, anything else is converted once on the way in. Paths come back as
+// arrays that take over the planner's vector of waypoints, so they are not copied either.
+// Planning and the batch queries release the GIL, so Python threads can plan in parallel.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include "Obstacles.hpp"
+#include "RRT.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Owning reference to a Python object, released when it goes out of scope.
+struct Decref{
+    void operator()(void* object) const{
+        Py_XDECREF(static_cast<PyObject*>(object));
+    }
+};
+using ArrayRef = std::unique_ptr<PyArrayObject, Decref>;
+
+// Let other Python threads run for as long as it is in scope, even if C++ throws.
+class ReleaseGil{
+public:
+    ReleaseGil() : m_state(PyEval_SaveThread()){
+    }
+    ~ReleaseGil(){
+        PyEval_RestoreThread(m_state);
+    }
+    ReleaseGil(const ReleaseGil&) = delete;
+    ReleaseGil& operator=(const ReleaseGil&) = delete;
+
+private:
+    PyThreadState* m_state;
+};
+
+// Run body, turning any C++ exception into the matching Python one and failed.
+template <typename Result, typename Body>
+Result translateExceptions(Result failed, Body body){
+    try{
+        return body();
+    }catch(RRTStartConfigExcption& e){
+        PyErr_SetString(PyExc_ValueError, e.message.c_str());
+    }catch(const std::invalid_argument& e){
+        PyErr_SetString(PyExc_ValueError, e.what());
+    }catch(const std::bad_alloc&){
+        PyErr_NoMemory();
+    }catch(const std::exception& e){
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+    }
+    return failed;
+}
+
+// View obj as a C contiguous float32 array of shape (n, columns), converting it only if it
+// is not one already. Null with a Python error set if it cannot be.
+ArrayRef floatRows(PyObject* obj, int columns, const char* name){
+    ArrayRef array(reinterpret_cast<PyArrayObject*>(PyArray_FROM_OTF(obj, NPY_FLOAT32, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST)));
+    if(array && (PyArray_NDIM(array.get()) != 2 || PyArray_DIM(array.get(), 1) != columns)){
+        PyErr_Format(PyExc_ValueError, "%s must be an (n, %d) array.", name, columns);
+        array.reset();
+    }
+    return array;
+}
+
+const float* floatData(const ArrayRef& array){
+    return static_cast<const float*>(PyArray_DATA(array.get()));
+}
+
+npy_intp rows(const ArrayRef& array){
+    return PyArray_DIM(array.get(), 0);
+}
+
+// Hand the path's storage to a new NumPy array of shape (n, 2).
+PyObject* toArray(std::vector<Vector2f> path){
+    static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Paths are returned as packed x, y pairs.");
+    npy_intp dims[2] = {npy_intp(path.size()), 2};
+    if(path.empty()){
+        return PyArray_ZEROS(2, dims, NPY_FLOAT32, 0);
+    }
+    auto owned = std::make_unique<std::vector<Vector2f>>(std::move(path));
+    PyObject* array = PyArray_SimpleNewFromData(2, dims, NPY_FLOAT32, owned->data());
+    if(array == nullptr){
+        return nullptr;
+    }
+    PyObject* capsule = PyCapsule_New(owned.get(), nullptr, [](PyObject* capsule){
+        delete static_cast<std::vector<Vector2f>*>(PyCapsule_GetPointer(capsule, nullptr));
+    });
+    if(capsule == nullptr){
+        Py_DECREF(array);
+        return nullptr;
+    }
+    owned.release();
+    // Steals the capsule, which frees the waypoints along with the array.
+    PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), capsule);
+    return array;
+}
+
+// Read an optional seed argument, None meaning seed from the clock as the planner does.
+bool parseSeed(PyObject* obj, std::optional<unsigned>& seed){
+    if(obj == nullptr || obj == Py_None){
+        return true;
+    }
+    unsigned long value = PyLong_AsUnsignedLong(obj);
+    if(PyErr_Occurred()){
+        return false;
+    }
+    seed = static_cast<unsigned>(value);
+    return true;
+}
+
+// The planner samples [0, width) x [0, height), so both must be positive. False with a
+// ValueError set if not.
+bool checkWorkspace(float width, float height){
+    if(!(width > 0 && height > 0)){
+        PyErr_SetString(PyExc_ValueError, "width and height must be positive.");
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<RRTStar> makePlanner(const Obstacles& obs, float width, float height, Vector2f start, Vector2f goal,
+                                     float goalRadius, float neighborhoodRadius, float stepSize, int maxIterations,
+                                     std::optional<unsigned> seed){
+    auto planner = std::make_unique<RRTStar>(Vector2f(0, 0), Vector2f(width, height), ObstacleCollision<2, float>(obs),
+                                             start, goal, goalRadius, neighborhoodRadius, stepSize, maxIterations);
+    if(seed){
+        planner->setSeed(*seed);
+    }
+    return planner;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Obstacles
+
+struct ObstaclesObject{
+    PyObject_HEAD
+    Obstacles* obs;
+};
+
+PyTypeObject* ObstaclesType = nullptr;
+
+int Obstacles_init(ObstaclesObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"source", "counts", "convex", nullptr};
+    PyObject* source = nullptr;
+    PyObject* countsArg = nullptr;
+    int convex = 0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$p", const_cast<char**>(keywords), &source, &countsArg, &convex)){
+        return -1;
+    }
+    if(countsArg == Py_None){
+        countsArg = nullptr;
+    }
+    // Planners and queries read the polygons without the GIL, so they are decomposed here,
+    // before anything else can see them, rather than by a method changing them later.
+    auto finish = [&](std::unique_ptr<Obstacles> obs){
+        if(convex){
+            obs->decomposeConvex();
+        }
+        self->obs = obs.release();
+        return 0;
+    };
+    // Planners may already hold on to the polygons, so they are never replaced.
+    if(self->obs != nullptr){
+        PyErr_SetString(PyExc_RuntimeError, "Obstacles is already initialized.");
+        return -1;
+    }
+
+    if(countsArg == nullptr){
+        PyObject* path = nullptr;
+        if(!PyUnicode_FSConverter(source, &path)){
+            return -1;
+        }
+        std::string filename(PyBytes_AS_STRING(path));
+        Py_DECREF(path);
+        return translateExceptions(-1, [&](){
+            ReleaseGil release;
+            return finish(std::make_unique<Obstacles>(filename));
+        });
+    }
+
+    ArrayRef vertices = floatRows(source, 2, "vertices");
+    if(!vertices){
+        return -1;
+    }
+    ArrayRef counts(reinterpret_cast<PyArrayObject*>(PyArray_FROM_OTF(countsArg, NPY_UINT32, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST)));
+    if(!counts){
+        return -1;
+    }
+    if(PyArray_NDIM(counts.get()) != 1){
+        PyErr_SetString(PyExc_ValueError, "counts must be a one dimensional array.");
+        return -1;
+    }
+    const uint32_t* countData = static_cast<const uint32_t*>(PyArray_DATA(counts.get()));
+    uint64_t total = 0;
+    for(npy_intp i = 0; i < rows(counts); i++){
+        total += countData[i];
+    }
+    if(total != uint64_t(rows(vertices))){
+        PyErr_SetString(PyExc_ValueError, "counts must add up to the number of vertices.");
+        return -1;
+    }
+    return translateExceptions(-1, [&](){
+        ReleaseGil release;
+        return finish(std::make_unique<Obstacles>(floatData(vertices), countData, rows(counts)));
+    });
+}
+
+void Obstacles_dealloc(ObstaclesObject* self){
+    PyTypeObject* type = Py_TYPE(self);
+    delete self->obs;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+// Every method needs a constructed Obstacles, which a subclass skipping __init__ lacks.
+bool checkInitialized(ObstaclesObject* self){
+    if(self->obs == nullptr){
+        PyErr_SetString(PyExc_RuntimeError, "Obstacles was not initialized.");
+        return false;
+    }
+    return true;
+}
+
+// Evaluate test(i) for i in [0, n) into a new boolean array, without the GIL.
+template <typename Test>
+PyObject* testEach(npy_intp n, Test test){
+    npy_intp dims[1] = {n};
+    PyObject* result = PyArray_SimpleNew(1, dims, NPY_BOOL);
+    if(result == nullptr){
+        return nullptr;
+    }
+    npy_bool* out = static_cast<npy_bool*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(result)));
+    {
+        ReleaseGil release;
+        for(npy_intp i = 0; i < n; i++){
+            out[i] = test(i);
+        }
+    }
+    return result;
+}
+
+PyObject* Obstacles_contains(ObstaclesObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"points", "radius", nullptr};
+    PyObject* pointsArg = nullptr;
+    float radius = 0;
+    if(!checkInitialized(self) ||
+       !PyArg_ParseTupleAndKeywords(args, kwargs, "O|f", const_cast<char**>(keywords), &pointsArg, &radius)){
+        return nullptr;
+    }
+    ArrayRef points = floatRows(pointsArg, 2, "points");
+    if(!points){
+        return nullptr;
+    }
+    const float* p = floatData(points);
+    const Obstacles& obs = *self->obs;
+    return testEach(rows(points), [&](npy_intp i){
+        return obs.inObstacles(Vector2f(p[2 * i], p[2 * i + 1]), radius);
+    });
+}
+
+PyObject* Obstacles_segmentsCollide(ObstaclesObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"a", "b", "radius", nullptr};
+    PyObject* aArg = nullptr;
+    PyObject* bArg = nullptr;
+    float radius = 0;
+    if(!checkInitialized(self) ||
+       !PyArg_ParseTupleAndKeywords(args, kwargs, "OO|f", const_cast<char**>(keywords), &aArg, &bArg, &radius)){
+        return nullptr;
+    }
+    ArrayRef a = floatRows(aArg, 2, "a");
+    ArrayRef b = a ? floatRows(bArg, 2, "b") : nullptr;
+    if(!a || !b){
+        return nullptr;
+    }
+    if(rows(a) != rows(b)){
+        PyErr_SetString(PyExc_ValueError, "a and b must hold the same number of points.");
+        return nullptr;
+    }
+    const float* pa = floatData(a);
+    const float* pb = floatData(b);
+    const Obstacles& obs = *self->obs;
+    return testEach(rows(a), [&](npy_intp i){
+        return obs.segmentInObstacles(Vector2f(pa[2 * i], pa[2 * i + 1]), Vector2f(pb[2 * i], pb[2 * i + 1]), radius);
+    });
+}
+
+PyObject* Obstacles_polygonCount(ObstaclesObject* self, void*){
+    if(!checkInitialized(self)){
+        return nullptr;
+    }
+    return PyLong_FromSize_t(self->obs->polygons().size());
+}
+
+PyMethodDef ObstaclesMethods[] = {
+    {"contains", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(Obstacles_contains)), METH_VARARGS | METH_KEYWORDS,
+     "contains(points, radius=0)\n--\n\n"
+     "For each row of an (n, 2) array of points, whether it is inside an obstacle, or within radius of one."},
+    {"segments_collide", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(Obstacles_segmentsCollide)), METH_VARARGS | METH_KEYWORDS,
+     "segments_collide(a, b, radius=0)\n--\n\n"
+     "For each segment from a row of a to the same row of b, whether it touches an obstacle,\n"
+     "or passes within radius of one."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef ObstaclesGetters[] = {
+    {"polygon_count", reinterpret_cast<getter>(Obstacles_polygonCount), nullptr, "Number of polygons.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+PyType_Slot ObstaclesSlots[] = {
+    {Py_tp_doc, const_cast<char*>(
+        "Obstacles(filename, *, convex=False) or Obstacles(vertices, counts, *, convex=False)\n--\n\n"
+        "Polygon obstacles, triangulated and indexed for collision queries. Loaded from a text or\n"
+        "binary obstacle file, or built from every polygon's vertices stacked in an (n, 2) array\n"
+        "with counts giving the number of vertices in each polygon. With convex=True the polygons\n"
+        "are also split into convex pieces, which makes collision queries faster. Never changes\n"
+        "once built, so any number of threads may query and plan on it.")},
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(Obstacles_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(Obstacles_dealloc)},
+    {Py_tp_methods, ObstaclesMethods},
+    {Py_tp_getset, ObstaclesGetters},
+    {0, nullptr}
+};
+
+PyType_Spec ObstaclesSpec = {"rrtstar.Obstacles", sizeof(ObstaclesObject), 0,
+                             Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, ObstaclesSlots};
+
+// The Obstacles behind obj, or null with a TypeError set if it is not one.
+const Obstacles* asObstacles(PyObject* obj){
+    if(!PyObject_TypeCheck(obj, ObstaclesType)){
+        PyErr_SetString(PyExc_TypeError, "obstacles must be an rrtstar.Obstacles.");
+        return nullptr;
+    }
+    ObstaclesObject* o = reinterpret_cast<ObstaclesObject*>(obj);
+    return checkInitialized(o) ? o->obs : nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------
+// RRTStar
+
+struct PlannerObject{
+    PyObject_HEAD
+    PyObject* obstacles; //< Kept alive for as long as the planner refers to it.
+    RRTStar* planner;
+};
+
+int Planner_init(PlannerObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"obstacles", "width", "height", "start", "goal", "goal_radius",
+                                     "neighborhood_radius", "step_size", "max_iterations", "seed", nullptr};
+    PyObject* obstaclesArg = nullptr;
+    float width, height, goalRadius;
+    Vector2f start, goal;
+    float neighborhoodRadius = 70;
+    float stepSize = 30;
+    int maxIterations = 3000;
+    PyObject* seedArg = nullptr;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "Off(ff)(ff)f|ffiO", const_cast<char**>(keywords),
+                                    &obstaclesArg, &width, &height, &start.x, &start.y, &goal.x, &goal.y,
+                                    &goalRadius, &neighborhoodRadius, &stepSize, &maxIterations, &seedArg)){
+        return -1;
+    }
+    const Obstacles* obs = asObstacles(obstaclesArg);
+    std::optional<unsigned> seed;
+    if(obs == nullptr || !parseSeed(seedArg, seed) || !checkWorkspace(width, height)){
+        return -1;
+    }
+    return translateExceptions(-1, [&](){
+        std::unique_ptr<RRTStar> planner = makePlanner(*obs, width, height, start, goal, goalRadius,
+                                                       neighborhoodRadius, stepSize, maxIterations, seed);
+        delete self->planner;
+        self->planner = planner.release();
+        Py_INCREF(obstaclesArg);
+        Py_XSETREF(self->obstacles, obstaclesArg);
+        return 0;
+    });
+}
+
+void Planner_dealloc(PlannerObject* self){
+    PyTypeObject* type = Py_TYPE(self);
+    delete self->planner;
+    Py_XDECREF(self->obstacles);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+bool checkInitialized(PlannerObject* self){
+    if(self->planner == nullptr){
+        PyErr_SetString(PyExc_RuntimeError, "RRTStar was not initialized.");
+        return false;
+    }
+    return true;
+}
+
+PyObject* Planner_findBestPath(PlannerObject* self, PyObject*){
+    if(!checkInitialized(self)){
+        return nullptr;
+    }
+    return translateExceptions<PyObject*>(nullptr, [&](){
+        std::vector<Vector2f> path;
+        {
+            ReleaseGil release;
+            path = self->planner->findBestPath();
+        }
+        return toArray(std::move(path));
+    });
+}
+
+PyObject* Planner_beginSearch(PlannerObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"stop_at_first_path", nullptr};
+    int stopAtFirstPath = 0;
+    if(!checkInitialized(self) ||
+       !PyArg_ParseTupleAndKeywords(args, kwargs, "|p", const_cast<char**>(keywords), &stopAtFirstPath)){
+        return nullptr;
+    }
+    self->planner->beginSearch(stopAtFirstPath);
+    Py_RETURN_NONE;
+}
+
+PyObject* Planner_step(PlannerObject* self, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"iterations", nullptr};
+    int iterations = 0;
+    if(!checkInitialized(self) ||
+       !PyArg_ParseTupleAndKeywords(args, kwargs, "i", const_cast<char**>(keywords), &iterations)){
+        return nullptr;
+    }
+    return translateExceptions<PyObject*>(nullptr, [&](){
+        PlanStatus status;
+        {
+            ReleaseGil release;
+            status = self->planner->step(iterations);
+        }
+        return PyBool_FromLong(status == PlanStatus::RUNNING);
+    });
+}
+
+PyObject* Planner_setSeed(PlannerObject* self, PyObject* arg){
+    unsigned long seed = PyLong_AsUnsignedLong(arg);
+    if(!checkInitialized(self) || PyErr_Occurred()){
+        return nullptr;
+    }
+    self->planner->setSeed(static_cast<unsigned>(seed));
+    Py_RETURN_NONE;
+}
+
+PyObject* Planner_bestPath(PlannerObject* self, void*){
+    if(!checkInitialized(self)){
+        return nullptr;
+    }
+    return translateExceptions<PyObject*>(nullptr, [&](){ return toArray(self->planner->bestPath()); });
+}
+
+PyObject* Planner_cost(PlannerObject* self, void*){
+    return checkInitialized(self) ? PyFloat_FromDouble(self->planner->getCost()) : nullptr;
+}
+
+PyObject* Planner_hasPath(PlannerObject* self, void*){
+    return checkInitialized(self) ? PyBool_FromLong(self->planner->hasPath()) : nullptr;
+}
+
+PyMethodDef PlannerMethods[] = {
+    {"find_best_path", reinterpret_cast<PyCFunction>(Planner_findBestPath), METH_NOARGS,
+     "Search until the first path, returned as an (n, 2) array from the goal back to the start,\n"
+     "empty if none was found. The GIL is released while searching."},
+    {"begin_search", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(Planner_beginSearch)), METH_VARARGS | METH_KEYWORDS,
+     "begin_search(stop_at_first_path=False)\n--\n\n"
+     "Start a new search, to be run with step."},
+    {"step", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(Planner_step)), METH_VARARGS | METH_KEYWORDS,
+     "step(iterations)\n--\n\n"
+     "Continue the search for up to the given number of iterations, without the GIL.\n"
+     "True while the search is still running."},
+    {"set_seed", reinterpret_cast<PyCFunction>(Planner_setSeed), METH_O,
+     "Seed the random samples, which are otherwise seeded from the clock."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef PlannerGetters[] = {
+    {"best_path", reinterpret_cast<getter>(Planner_bestPath), nullptr,
+     "Best path found so far, from the goal back to the start.", nullptr},
+    {"cost", reinterpret_cast<getter>(Planner_cost), nullptr, "Cost of the best path found so far.", nullptr},
+    {"has_path", reinterpret_cast<getter>(Planner_hasPath), nullptr, "Whether a path has been found.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+PyType_Slot PlannerSlots[] = {
+    {Py_tp_doc, const_cast<char*>(
+        "RRTStar(obstacles, width, height, start, goal, goal_radius, neighborhood_radius=70,\n"
+        "        step_size=30, max_iterations=3000, seed=None)\n--\n\n"
+        "RRT* planner over the workspace [0, width) x [0, height). Not safe to use from several\n"
+        "threads at once, make one per thread.")},
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(Planner_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(Planner_dealloc)},
+    {Py_tp_methods, PlannerMethods},
+    {Py_tp_getset, PlannerGetters},
+    {0, nullptr}
+};
+
+PyType_Spec PlannerSpec = {"rrtstar.RRTStar", sizeof(PlannerObject), 0,
+                           Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, PlannerSlots};
+
+// ---------------------------------------------------------------------------------------------
+// Batch planning
+
+// Plan every row of queries, (start x, start y, goal x, goal y, goal radius), spread over
+// threads. A query whose start is inside an obstacle finds no path. Any other exception stops
+// the remaining queries and the first one is rethrown once every thread has finished, as
+// one escaping a thread would end the process.
+void planBatch(const Obstacles& obs, float width, float height, const float* queries, size_t count, int maxIterations,
+               int threads, std::optional<unsigned> seed, std::vector<std::vector<Vector2f>>& paths, std::vector<float>& costs){
+    paths.assign(count, {});
+    costs.assign(count, std::numeric_limits<float>::infinity());
+    std::atomic<size_t> next{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto work = [&](){
+        for(size_t i = next++; i < count; i = next++){
+            const float* q = queries + 5 * i;
+            std::optional<unsigned> querySeed;
+            if(seed){
+                querySeed = *seed + unsigned(i);
+            }
+            try{
+                auto planner = makePlanner(obs, width, height, {q[0], q[1]}, {q[2], q[3]}, q[4], 70, 30, maxIterations, querySeed);
+                paths[i] = planner->findBestPath();
+                if(!paths[i].empty()){
+                    costs[i] = planner->getCost();
+                }
+            }catch(RRTStartConfigExcption&){
+            }catch(const std::exception&){
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if(!error){
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    if(threads <= 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = int(std::min<size_t>(threads, std::max<size_t>(count, 1)));
+    std::vector<std::thread> workers;
+    for(int t = 1; t < threads; t++){
+        workers.emplace_back(work);
+    }
+    work();
+    for(std::thread& worker : workers){
+        worker.join();
+    }
+    if(error){
+        std::rethrow_exception(error);
+    }
+}
+
+PyObject* planBatchFunction(PyObject*, PyObject* args, PyObject* kwargs){
+    static const char* keywords[] = {"obstacles", "width", "height", "queries", "max_iterations", "threads", "seed", nullptr};
+    PyObject* obstaclesArg = nullptr;
+    float width, height;
+    PyObject* queriesArg = nullptr;
+    int maxIterations = 3000;
+    int threads = 0;
+    PyObject* seedArg = nullptr;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "OffO|iiO", const_cast<char**>(keywords), &obstaclesArg,
+                                    &width, &height, &queriesArg, &maxIterations, &threads, &seedArg)){
+        return nullptr;
+    }
+    const Obstacles* obs = asObstacles(obstaclesArg);
+    std::optional<unsigned> seed;
+    if(obs == nullptr || !parseSeed(seedArg, seed) || !checkWorkspace(width, height)){
+        return nullptr;
+    }
+    ArrayRef queries = floatRows(queriesArg, 5, "queries");
+    if(!queries){
+        return nullptr;
+    }
+
+    return translateExceptions<PyObject*>(nullptr, [&]() -> PyObject*{
+        std::vector<std::vector<Vector2f>> paths;
+        std::vector<float> costs;
+        {
+            ReleaseGil release;
+            planBatch(*obs, width, height, floatData(queries), rows(queries), maxIterations, threads, seed, paths, costs);
+        }
+
+        std::unique_ptr<PyObject, Decref> pathList(PyList_New(paths.size()));
+        npy_intp dims[1] = {npy_intp(costs.size())};
+        std::unique_ptr<PyObject, Decref> costArray(PyArray_SimpleNew(1, dims, NPY_FLOAT32));
+        if(!pathList || !costArray){
+            return nullptr;
+        }
+        for(size_t i = 0; i < paths.size(); i++){
+            PyObject* path = toArray(std::move(paths[i]));
+            if(path == nullptr){
+                return nullptr;
+            }
+            PyList_SET_ITEM(pathList.get(), i, path);
+        }
+        std::copy(costs.begin(), costs.end(), static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(costArray.get()))));
+        return PyTuple_Pack(2, pathList.get(), costArray.get());
+    });
+}
+
+PyMethodDef ModuleMethods[] = {
+    {"plan_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(planBatchFunction)), METH_VARARGS | METH_KEYWORDS,
+     "plan_batch(obstacles, width, height, queries, max_iterations=3000, threads=0, seed=None)\n--\n\n"
+     "Plan every row of an (n, 5) array of start x, start y, goal x, goal y and goal radius on a\n"
+     "pool of threads (one per core for threads=0) without the GIL. Returns the list of paths, each\n"
+     "from the goal back to the start, and an array of their costs, infinite where no path was found."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef Module = {PyModuleDef_HEAD_INIT, "rrtstar", "RRT* path planning among polygon obstacles.", -1, ModuleMethods,
+                      nullptr, nullptr, nullptr, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_rrtstar(){
+    import_array();
+
+    PyObject* module = PyModule_Create(&Module);
+    if(module == nullptr){
+        return nullptr;
+    }
+    ObstaclesType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&ObstaclesSpec));
+    PyObject* plannerType = PyType_FromSpec(&PlannerSpec);
+    if(ObstaclesType == nullptr || plannerType == nullptr
+       || PyModule_AddObjectRef(module, "Obstacles", reinterpret_cast<PyObject*>(ObstaclesType)) < 0
+       || PyModule_AddObject(module, "RRTStar", plannerType) < 0){
+        Py_XDECREF(plannerType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
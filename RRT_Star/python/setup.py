@@ -0,0 +1,35 @@
+# Build the Python bindings for the planner, which need only NumPy.
+# Run with: pip install ./python                  (from RRT_Star, installs the rrtstar module)
+#      or:  python3 setup.py build_ext --inplace  (from here, builds it next to this file)
+import glob
+import os
+import platform
+
+import numpy
+from setuptools import Extension, setup
+
+ROOT = os.path.relpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+# Same sources as the benchmarks: everything but the viewer, built without SDL.
+SOURCES = ["rrtstar_module.cpp"] + [f for f in sorted(glob.glob(os.path.join(ROOT, "src", "*.cpp"))) if not f.endswith("main.cpp")]
+
+MACROS = [("HEADLESS", None)]
+if platform.system() == "Linux":
+    MACROS.append(("LINUX", None))
+elif platform.system() == "Darwin":
+    MACROS.append(("MAC", None))
+elif platform.system() == "Windows":
+    MACROS.append(("MINGW", None))
+
+setup(
+    name="rrtstar",
+    version="0.1.0",
+    description="RRT* path planning among polygon obstacles",
+    ext_modules=[Extension("rrtstar", SOURCES,
+                           include_dirs=[os.path.join(ROOT, "include"), numpy.get_include()],
+                           define_macros=MACROS,
+                           extra_compile_args=["-std=c++20", "-O2"],
+                           language="c++")],
+    install_requires=["numpy"],
+    zip_safe=False,
+)
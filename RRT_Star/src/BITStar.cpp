@@ -0,0 +1,4 @@
+#include "BITStar.hpp"
+
+// The planar planner is compiled here once rather than in every file that uses it.
+template class BITStarN<2, float>;
@@ -0,0 +1,147 @@
+#include "DistanceField.hpp"
+
+#include <cmath>
+
+namespace {
+
+const float FAR = 1e20f;
+
+// Squared distance transform of one row or column, Felzenszwalb and Huttenlocher's lower
+// envelope of parabolas: d[q] = min over p of (q - p)^2 + f[p]. v and z are scratch space
+// of n and n + 1 entries.
+void Transform1D(const float* f, float* d, int n, int* v, float* z)
+{
+    // v[0..k] are the sites whose parabolas make up the envelope, parabola v[i] being lowest
+    // between z[i] and z[i + 1]. Cells without a site are left out.
+    int k = -1;
+    for(int q = 0; q < n; q++){
+        if(f[q] >= FAR){
+            continue;
+        }
+        float s = -FAR;
+        while(k >= 0){
+            int p = v[k];
+            s = ((f[q] + float(q) * q) - (f[p] + float(p) * p)) / (2.0f * (q - p));
+            if(s > z[k]){
+                break;
+            }
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = k == 0 ? -FAR : s;
+        z[k + 1] = FAR;
+    }
+
+    if(k < 0){
+        std::fill(d, d + n, FAR);
+        return;
+    }
+    k = 0;
+    for(int q = 0; q < n; q++){
+        while(z[k + 1] < q){
+            k++;
+        }
+        float offset = float(q - v[k]);
+        d[q] = offset * offset + f[v[k]];
+    }
+}
+
+// Squared distance, in cells, from each cell to the nearest cell with grid value 0, for a
+// grid holding 0 at those cells and FAR everywhere else.
+void Transform2D(std::vector<float>& grid, int cols, int rows)
+{
+    int n = std::max(cols, rows);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for(int c = 0; c < cols; c++){
+        for(int r = 0; r < rows; r++){
+            f[r] = grid[r * cols + c];
+        }
+        Transform1D(f.data(), d.data(), rows, v.data(), z.data());
+        for(int r = 0; r < rows; r++){
+            grid[r * cols + c] = d[r];
+        }
+    }
+    for(int r = 0; r < rows; r++){
+        std::copy(grid.begin() + r * cols, grid.begin() + (r + 1) * cols, f.begin());
+        Transform1D(f.data(), d.data(), cols, v.data(), z.data());
+        std::copy(d.begin(), d.begin() + cols, grid.begin() + r * cols);
+    }
+}
+
+} // namespace
+
+DistanceField::DistanceField(const Obstacles& obs, float xMax, float yMax, float cellSize)
+    : m_cellSize(cellSize),
+      m_cols(std::max(1, int(std::ceil(xMax / cellSize)))),
+      m_rows(std::max(1, int(std::ceil(yMax / cellSize))))
+{
+    // A cell touches an obstacle if its center is inside one, or else the obstacle's boundary
+    // must cross the cell. Obstacles beyond the workspace mark the edge cells nearest them,
+    // which are at least as close to every point inside.
+    std::vector<char> occupied(size_t(m_cols) * m_rows, 0);
+    for(int r = 0; r < m_rows; r++){
+        for(int c = 0; c < m_cols; c++){
+            Vector2f center((c + 0.5f) * m_cellSize, (r + 0.5f) * m_cellSize);
+            occupied[r * m_cols + c] = obs.inObstacles(center);
+        }
+    }
+
+    auto column = [&](float x){ return std::clamp(int(std::floor(x / m_cellSize)), 0, m_cols - 1); };
+    auto row = [&](float y){ return std::clamp(int(std::floor(y / m_cellSize)), 0, m_rows - 1); };
+    float pad = m_cellSize * 1e-3f;
+    auto markEdge = [&](const Vector2f& a, const Vector2f& b){
+        float minY = std::min(a.y, b.y);
+        float maxY = std::max(a.y, b.y);
+        for(int r = row(minY - pad); r <= row(maxY + pad); r++){
+            // Part of the edge in this row, the outer rows reaching out past the workspace.
+            float low = std::max(minY, r == 0 ? -FAR : r * m_cellSize - pad);
+            float high = std::min(maxY, r == m_rows - 1 ? FAR : (r + 1) * m_cellSize + pad);
+            if(low > high){
+                continue;
+            }
+            float xLow = std::min(a.x, b.x);
+            float xHigh = std::max(a.x, b.x);
+            if(a.y != b.y){
+                float x1 = a.x + (low - a.y) * (b.x - a.x) / (b.y - a.y);
+                float x2 = a.x + (high - a.y) * (b.x - a.x) / (b.y - a.y);
+                xLow = std::max(xLow, std::min(x1, x2));
+                xHigh = std::min(xHigh, std::max(x1, x2));
+            }
+            for(int c = column(xLow - pad); c <= column(xHigh + pad); c++){
+                occupied[r * m_cols + c] = 1;
+            }
+        }
+    };
+    for(const Polygon& polygon : obs.polygons()){
+        size_t n = polygon.vertices.size();
+        for(size_t i = 0; i < n; i++){
+            markEdge(polygon.vertices[i], polygon.vertices[(i + 1) % n]);
+        }
+    }
+
+    // Distance from each free cell's center to the nearest touched cell's center, and the
+    // other way around for touched cells.
+    std::vector<float> toObstacle(occupied.size());
+    std::vector<float> toFree(occupied.size());
+    for(size_t i = 0; i < occupied.size(); i++){
+        toObstacle[i] = occupied[i] ? 0 : FAR;
+        toFree[i] = occupied[i] ? FAR : 0;
+    }
+    Transform2D(toObstacle, m_cols, m_rows);
+    Transform2D(toFree, m_cols, m_rows);
+
+    // Any point of a cell is within half a diagonal of its center, and so is the obstacle in
+    // the touched cell, so the clearance is at least the distance between centers less one
+    // cell diagonal.
+    m_distance.resize(occupied.size());
+    for(size_t i = 0; i < occupied.size(); i++){
+        if(occupied[i]){
+            m_distance[i] = -std::sqrt(toFree[i]) * m_cellSize;
+        }else{
+            m_distance[i] = std::max(0.0f, (std::sqrt(toObstacle[i]) - std::sqrt(2.0f)) * m_cellSize);
+        }
+    }
+}
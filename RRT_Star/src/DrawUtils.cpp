@@ -1,3 +1,5 @@
+#ifndef HEADLESS
+
 #include "DrawUtils.hpp"
 
 #include <cmath>
@@ -5,20 +7,111 @@
 
 // Helper funciton to draw a circle at center with radius, done simply by
 // drawing dotted points around the circle for ease of implementation
-void drawDottedCircle(SDL_Renderer* renderer,  Vector2f& center, int radius){
-    SDL_SetRenderDrawColor(renderer,200,30,30,SDL_ALPHA_OPAQUE);
-    for(float theta = 0; theta < (M_PI * 2); theta += ((M_PI * 2) / 40)){
-        float x = center.x + radius * cos(theta);
-        float y = center.y + radius * sin(theta);
-        SDL_RenderDrawPoint(renderer,x,y);
+void drawDottedCircle(SDL_Renderer* renderer, const Vector2f& center, int radius){
+    const int DOTS = 40;
+    SDL_FPoint points[DOTS];
+    for(int i = 0; i < DOTS; i++){
+        float theta = i * (M_PI * 2) / DOTS;
+        points[i] = {center.x + radius * cosf(theta), center.y + radius * sinf(theta)};
     }
+    SDL_SetRenderDrawColor(renderer,200,30,30,SDL_ALPHA_OPAQUE);
+    SDL_RenderDrawPointsF(renderer, points, DOTS);
 }
 
 // Draw a thicker point
 void DrawPointScaled(SDL_Renderer* renderer, int x, int y, size_t size){
-    for(int s = x; s < x+size; ++s){
-        for(int t = y; t < y+size; ++t){
-            SDL_RenderDrawPoint(renderer,s,t);
+    SDL_Rect square = {x, y, (int)size, (int)size};
+    SDL_RenderFillRect(renderer, &square);
+}
+
+void GeometryBatch::clear()
+{
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void GeometryBatch::addQuad(const SDL_FPoint corners[4], SDL_Color color)
+{
+    int first = m_vertices.size();
+    for(int i = 0; i < 4; i++){
+        m_vertices.push_back({corners[i], color, {0, 0}});
+    }
+    // Two triangles, corners 0 1 2 and 0 2 3.
+    const int QUAD[6] = {0, 1, 2, 0, 2, 3};
+    for(int index : QUAD){
+        m_indices.push_back(first + index);
+    }
+}
+
+void GeometryBatch::addLine(float x1, float y1, float x2, float y2, SDL_Color color, float width)
+{
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if(length == 0.0f){
+        return;
+    }
+    // Offset both ends half the width to either side of the line.
+    float nx = -dy / length * width / 2;
+    float ny = dx / length * width / 2;
+    SDL_FPoint corners[4] = {{x1 + nx, y1 + ny}, {x2 + nx, y2 + ny}, {x2 - nx, y2 - ny}, {x1 - nx, y1 - ny}};
+    addQuad(corners, color);
+}
+
+void GeometryBatch::addPoint(float x, float y, SDL_Color color, float size)
+{
+    SDL_FPoint corners[4] = {{x, y}, {x + size, y}, {x + size, y + size}, {x, y + size}};
+    addQuad(corners, color);
+}
+
+void GeometryBatch::render(SDL_Renderer* renderer) const
+{
+    if(m_indices.empty()){
+        return;
+    }
+    SDL_RenderGeometry(renderer, nullptr, m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size());
+}
+
+CachedLayer::~CachedLayer()
+{
+    if(m_texture != nullptr){
+        SDL_DestroyTexture(m_texture);
+    }
+}
+
+bool CachedLayer::prepare(SDL_Renderer* renderer)
+{
+    int width, height;
+    if(m_unsupported || SDL_GetRendererOutputSize(renderer, &width, &height) != 0){
+        return false;
+    }
+    if(m_texture != nullptr && width == m_width && height == m_height){
+        return true;
+    }
+
+    if(m_texture != nullptr){
+        SDL_DestroyTexture(m_texture);
+    }
+    m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    // Blending into the cleared texture already multiplies each colour by its alpha, so the
+    // texture holds premultiplied colour and must not be scaled by its alpha a second time.
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if(m_texture == nullptr || SDL_SetTextureBlendMode(m_texture, premultiplied) != 0){
+        // Renderers without render target or custom blend support will not manage it on
+        // later frames either.
+        if(m_texture != nullptr){
+            SDL_DestroyTexture(m_texture);
+            m_texture = nullptr;
         }
+        m_unsupported = true;
+        return false;
     }
-}
\ No newline at end of file
+    m_width = width;
+    m_height = height;
+    m_dirty = true;
+    return true;
+}
+
+#endif
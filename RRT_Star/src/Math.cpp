@@ -1,4 +1,5 @@
 #include "Math.hpp"
+#include "Predicates.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -30,7 +31,7 @@ Vector2f CreateMidpoint(const Vector2f& a, const Vector2f& b)
 
 int isLeft(const Vector2f& a, const Vector2f& b, const Vector2f& point)
 {
-    return ( (b.x - a.x) * (point.y - a.y) - (point.x - a.x) * (b.y - a.y) );
+    return Orient2D(a, b, point);
 }
 
 float Distance(const Vector2f& a, const Vector2f& b)
@@ -41,14 +42,11 @@ float Distance(const Vector2f& a, const Vector2f& b)
 
 ORIENTATION GetOrientation(Vector2f p, Vector2f q, Vector2f r)
 {
-    Vector2f pq = q - p;
-    Vector2f qr = r - q;
+    int orientation = Orient2D(p, q, r);
 
-    int crossProd = Cross(pq, qr);
-
-    if(crossProd > 0){
+    if(orientation > 0){
         return ORIENTATION::COUNTERCLOCKWISE;
-    }else if(crossProd < 0){
+    }else if(orientation < 0){
         return ORIENTATION::CLOCKWISE;
     }else{
         return ORIENTATION::COLLINEAR;
@@ -66,13 +64,49 @@ bool PointLiesOnSegment(const Vector2f& a, const Vector2f& b, const Vector2f& p)
 	}
 }
 
+float PointSegmentDistance(const Vector2f& p, const Vector2f& a, const Vector2f& b)
+{
+	Vector2f ab = b - a;
+	float length = Dot(ab, ab);
+	if(length == 0){
+		return Distance(p, a);
+	}
+	// Project onto the segment's line, clamped to the segment.
+	float t = std::clamp(Dot(p - a, ab) / length, 0.0f, 1.0f);
+	return Distance(p, a + ab * t);
+}
+
+float SegmentDistance(const Vector2f& a1, const Vector2f& b1, const Vector2f& a2, const Vector2f& b2)
+{
+	if(SegmentsIntersect(a1, b1, a2, b2)){
+		return 0;
+	}
+	// Segments that do not cross are closest at an end point of one of them.
+	return std::min(std::min(PointSegmentDistance(a1, a2, b2), PointSegmentDistance(b1, a2, b2)),
+	                std::min(PointSegmentDistance(a2, a1, b1), PointSegmentDistance(b2, a1, b1)));
+}
+
 bool PointInTriangle(const Vector2f& v, const Vector2f& a, const Vector2f& b, const Vector2f& c)
 {
-	int first  = isLeft(a,b,v);	
-	int second = isLeft(b,c,v);	
-	int third  = isLeft(c,a,v);	
+	// The float filter of Orient2DFloatFilter applied to all three edges at once, with
+	// the largest of their error bounds standing in for each. A determinant certainly
+	// negative means outside, all certainly positive means inside.
+	float left1  = (b.x - a.x) * (v.y - a.y), right1 = (b.y - a.y) * (v.x - a.x);
+	float left2  = (c.x - b.x) * (v.y - b.y), right2 = (c.y - b.y) * (v.x - b.x);
+	float left3  = (a.x - c.x) * (v.y - c.y), right3 = (a.y - c.y) * (v.x - c.x);
+	float smallest = std::min(left1 - right1, std::min(left2 - right2, left3 - right3));
+	float magnitude = std::max(std::fabs(left1) + std::fabs(right1),
+	                  std::max(std::fabs(left2) + std::fabs(right2), std::fabs(left3) + std::fabs(right3)));
+	float bound = ORIENT_ERROR_BOUND * magnitude + ORIENT_UNDERFLOW_BOUND;
+	if(smallest < -bound){
+		return false;
+	}
+	if(smallest > bound){
+		return true;
+	}
 
-	return (first>0 && second>0 && third>0);
+	// Close to an edge, settle it exactly.
+	return isLeft(a,b,v) >= 0 && isLeft(b,c,v) >= 0 && isLeft(c,a,v) >= 0;
 }
 
 bool SegmentsIntersect(const Vector2f& a1, const Vector2f& b1, const Vector2f& a2, const Vector2f& b2)
@@ -107,7 +141,7 @@ bool SegmentsIntersect(const Vector2f& a1, const Vector2f& b1, const Vector2f& a
 }
 
 
-bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, std::vector<Vector2f>& triangle)
+bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, const std::array<Vector2f, 3>& triangle)
 {
    
    // Case 1: The segment intersects with one of the polygon edges.
@@ -130,4 +164,55 @@ bool SegmentInTriangle(const Vector2f& a, const Vector2f& b, std::vector<Vector2
    // Otherwise segment must be entirely outside polygon.
    return false;
 
-}
\ No newline at end of file
+}
+
+bool PointInConvexPolygon(const Vector2f& v, const std::vector<Vector2f>& polygon)
+{
+	int n = polygon.size();
+	if(n < 3){
+		return false;
+	}
+
+	// Outside the wedge spanned by the fan from the first vertex.
+	const Vector2f& origin = polygon[0];
+	if(isLeft(origin, polygon[1], v) < 0 || isLeft(origin, polygon[n - 1], v) > 0){
+		return false;
+	}
+
+	// Binary search for the fan triangle origin, polygon[low], polygon[low + 1] holding v.
+	int low = 1;
+	int high = n - 1;
+	while(high - low > 1){
+		int mid = (low + high) / 2;
+		if(isLeft(origin, polygon[mid], v) >= 0){
+			low = mid;
+		}else{
+			high = mid;
+		}
+	}
+
+	return isLeft(polygon[low], polygon[low + 1], v) >= 0;
+}
+
+bool SegmentInConvexPolygon(const Vector2f& a, const Vector2f& b, const std::vector<Vector2f>& polygon)
+{
+	// The segment misses a convex polygon exactly when one of the polygon's edges, or the
+	// segment's own line, has the segment and the polygon strictly on opposite sides.
+	// Every test is an exact orientation, so this agrees with SegmentInTriangle.
+	for(size_t i = 0; i < polygon.size(); i++){
+		const Vector2f& p = polygon[i];
+		const Vector2f& q = polygon[(i + 1) % polygon.size()];
+		if(Orient2D(p, q, a) < 0 && Orient2D(p, q, b) < 0){
+			return false;
+		}
+	}
+
+	bool left = false;
+	bool right = false;
+	for(const Vector2f& p : polygon){
+		int side = Orient2D(a, b, p);
+		left = left || side >= 0;
+		right = right || side <= 0;
+	}
+	return left && right;
+}
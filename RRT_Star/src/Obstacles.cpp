@@ -0,0 +1,302 @@
+#include "Obstacles.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(LINUX) || defined(MAC)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+// Leading bytes of every binary obstacle file.
+const char BINARY_MAGIC[8] = {'R', 'R', 'T', 'O', 'B', 'S', '\0', '\0'};
+const uint32_t BINARY_VERSION = 1;
+
+// Layout of the binary format (native byte order, all fields 4 bytes wide):
+//   header:      magic[8], version, polygon count
+//   per polygon: vertex count, triangle count,
+//                vertex count * (x, y) floats,
+//                triangle count * 3 vertex indices
+struct BinaryHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t polygonCount;
+};
+
+/// Read only view of a whole file. Memory mapped where the platform supports it
+/// so the loaders can walk the bytes without reading them into a buffer first.
+class MappedFile{
+public:
+    MappedFile(const std::string& filename){
+#if defined(LINUX) || defined(MAC)
+        int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0){
+            throw std::invalid_argument("Unable to open file.");
+        }
+        struct stat info;
+        if(fstat(fd, &info) != 0){
+            close(fd);
+            throw std::invalid_argument("Unable to open file.");
+        }
+        m_size = info.st_size;
+        if(m_size > 0){
+            void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped == MAP_FAILED){
+                close(fd);
+                throw std::invalid_argument("Unable to map file.");
+            }
+            madvise(mapped, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(mapped);
+        }
+        close(fd);
+#else
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if(!file.is_open()){
+            throw std::invalid_argument("Unable to open file.");
+        }
+        m_buffer.resize(file.tellg());
+        file.seekg(0);
+        file.read(m_buffer.data(), m_buffer.size());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    }
+
+    ~MappedFile(){
+#if defined(LINUX) || defined(MAC)
+        if(m_data != nullptr){
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#if !(defined(LINUX) || defined(MAC))
+    std::vector<char> m_buffer;
+#endif
+};
+
+// Skip spaces, tabs and carriage returns, but not the end of the line.
+const char* skipBlanks(const char* p, const char* end){
+    while(p != end && (*p == ' ' || *p == '\t' || *p == '\r')){
+        p++;
+    }
+    return p;
+}
+
+// Parse one coordinate. std::from_chars rejects the leading '+' that std::stof, which the
+// loader used before, accepted, so one is skipped here.
+std::from_chars_result parseCoordinate(const char* p, const char* end, float& value){
+    if(p != end && *p == '+' && end - p > 1 && p[1] != '+' && p[1] != '-'){
+        p++;
+    }
+    return std::from_chars(p, end, value);
+}
+
+void throwMalformed(size_t lineNumber){
+    throw std::invalid_argument("Malformed point definition on line " + std::to_string(lineNumber) +
+                                ". For each vertex specify as 'x y' on a single line.");
+}
+
+// Read a fixed size value out of the binary file, checking that it is in bounds.
+template <typename T>
+T readValue(const char*& p, const char* end){
+    if(static_cast<size_t>(end - p) < sizeof(T)){
+        throw std::invalid_argument("Truncated binary obstacle file.");
+    }
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+}
+
+} // namespace
+
+Obstacles::Obstacles(const std::string& filename)
+{
+    MappedFile file(filename);
+
+    if(file.size() >= sizeof(BINARY_MAGIC) && std::memcmp(file.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0){
+        loadBinary(file.data(), file.size());
+    }else{
+        loadText(file.data(), file.size());
+    }
+    buildBroadphase();
+}
+
+Obstacles::Obstacles(const float* xy, const uint32_t* counts, size_t polygonCount)
+{
+    m_polygons.reserve(polygonCount);
+    for(size_t i = 0; i < polygonCount; i++){
+        if(counts[i] == 0){
+            continue;
+        }
+        std::vector<Vertex> vertices(counts[i]);
+        for(Vertex& v : vertices){
+            v = Vertex(xy[0], xy[1]);
+            xy += 2;
+        }
+        m_polygons.push_back(Polygon(std::move(vertices)));
+        m_polygons.back().TriangulateMonotone();
+    }
+    buildBroadphase();
+}
+
+void Obstacles::buildBroadphase()
+{
+    m_shapes.clear();
+    std::vector<Box> boxes;
+    for(size_t i = 0; i < m_polygons.size(); i++){
+        const Polygon& polygon = m_polygons[i];
+        if(!polygon.convexParts.empty()){
+            for(size_t k = 0; k < polygon.convexParts.size(); k++){
+                m_shapes.push_back({int(i), int(k)});
+                boxes.push_back(Box::Around(polygon.convexParts[k]));
+            }
+        }else{
+            for(size_t k = 0; k < polygon.triangles.size(); k++){
+                const Triangle& t = polygon.triangles[k];
+                m_shapes.push_back({int(i), int(k)});
+                boxes.push_back(Box::Around({t[0], t[1], t[2]}));
+            }
+        }
+    }
+    m_grid.build(boxes);
+}
+
+void Obstacles::loadText(const char* data, size_t size)
+{
+    const char* p = data;
+    const char* end = data + size;
+    size_t lineNumber = 0;
+    std::vector<Vertex> temp;
+
+    auto finishPolygon = [&](){
+        // Repeated empty lines would otherwise produce empty polygons.
+        if(temp.empty()){
+            return;
+        }
+        m_polygons.push_back(Polygon(std::move(temp)));
+        m_polygons.back().TriangulateMonotone();
+        temp.clear();
+    };
+
+    while(p != end){
+        lineNumber++;
+        p = skipBlanks(p, end);
+
+        // An empty line ends the current polygon.
+        if(p == end || *p == '\n'){
+            finishPolygon();
+            if(p != end){
+                p++;
+            }
+            continue;
+        }
+
+        Vertex v;
+        auto [xEnd, xError] = parseCoordinate(p, end, v.x);
+        if(xError != std::errc()){
+            throwMalformed(lineNumber);
+        }
+        p = skipBlanks(xEnd, end);
+        auto [yEnd, yError] = parseCoordinate(p, end, v.y);
+        if(yError != std::errc() || p == xEnd){
+            throwMalformed(lineNumber);
+        }
+        p = skipBlanks(yEnd, end);
+        if(p != end && *p != '\n'){
+            throwMalformed(lineNumber);
+        }
+        if(p != end){
+            p++;
+        }
+
+        temp.push_back(v);
+    }
+    finishPolygon();
+}
+
+void Obstacles::loadBinary(const char* data, size_t size)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    BinaryHeader header = readValue<BinaryHeader>(p, end);
+    if(header.version != BINARY_VERSION){
+        throw std::invalid_argument("Unsupported binary obstacle file version.");
+    }
+
+    m_polygons.reserve(header.polygonCount);
+    for(uint32_t i = 0; i < header.polygonCount; i++){
+        uint32_t vertexCount = readValue<uint32_t>(p, end);
+        uint32_t triangleCount = readValue<uint32_t>(p, end);
+
+        size_t vertexBytes = size_t(vertexCount) * 2 * sizeof(float);
+        size_t indexBytes = size_t(triangleCount) * 3 * sizeof(uint32_t);
+        if(static_cast<size_t>(end - p) < vertexBytes + indexBytes){
+            throw std::invalid_argument("Truncated binary obstacle file.");
+        }
+
+        // Vector2f is two packed floats, so both arrays are copied out in one go.
+        std::vector<Vertex> vertices(vertexCount);
+        std::memcpy(static_cast<void*>(vertices.data()), p, vertexBytes);
+        p += vertexBytes;
+
+        std::vector<int> indices(size_t(triangleCount) * 3);
+        std::memcpy(indices.data(), p, indexBytes);
+        p += indexBytes;
+
+        for(int index : indices){
+            if(index < 0 || static_cast<uint32_t>(index) >= vertexCount){
+                throw std::invalid_argument("Triangle index out of range in binary obstacle file.");
+            }
+        }
+
+        m_polygons.push_back(Polygon(std::move(vertices), std::move(indices)));
+    }
+}
+
+void Obstacles::saveBinary(const std::string& filename) const
+{
+    static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Binary format expects packed vertices.");
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file.is_open()){
+        throw std::invalid_argument("Unable to open file.");
+    }
+
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.polygonCount = m_polygons.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for(const Polygon& polygon : m_polygons){
+        uint32_t vertexCount = polygon.vertices.size();
+        uint32_t triangleCount = polygon.triangleIndices.size() / 3;
+        file.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
+        file.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+        file.write(reinterpret_cast<const char*>(polygon.vertices.data()), vertexCount * sizeof(Vector2f));
+        file.write(reinterpret_cast<const char*>(polygon.triangleIndices.data()), polygon.triangleIndices.size() * sizeof(int));
+    }
+
+    if(!file){
+        throw std::runtime_error("Failed writing binary obstacle file.");
+    }
+}
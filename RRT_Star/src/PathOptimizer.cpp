@@ -0,0 +1,193 @@
+#include "PathOptimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+Vector2f Lerp(const Vector2f& a, const Vector2f& b, float t)
+{
+    return a + (b - a) * t;
+}
+
+// Point at parameter t in [t1, t2] of the centripetal Catmull-Rom spline through p0..p3 with
+// knots t0..t3 (Barry and Goldman's pyramidal form).
+Vector2f CatmullRom(const Vector2f& p0, const Vector2f& p1, const Vector2f& p2, const Vector2f& p3,
+                    float t0, float t1, float t2, float t3, float t)
+{
+    Vector2f a1 = Lerp(p0, p1, (t - t0) / (t1 - t0));
+    Vector2f a2 = Lerp(p1, p2, (t - t1) / (t2 - t1));
+    Vector2f a3 = Lerp(p2, p3, (t - t2) / (t3 - t2));
+    Vector2f b1 = Lerp(a1, a2, (t - t0) / (t2 - t0));
+    Vector2f b2 = Lerp(a2, a3, (t - t1) / (t3 - t1));
+    return Lerp(b1, b2, (t - t1) / (t2 - t1));
+}
+
+} // namespace
+
+PathOptimizer::PathOptimizer(const Obstacles& obs, float radius, unsigned seed) : m_obs(&obs), m_radius(radius), m_rng(seed)
+{
+}
+
+float PathOptimizer::PathCost(const std::vector<Vector2f>& path)
+{
+    float cost = 0;
+    for(size_t i = 1; i < path.size(); i++){
+        cost += Distance(path[i - 1], path[i]);
+    }
+    return cost;
+}
+
+std::vector<Vector2f> PathOptimizer::shortcutGreedy(const std::vector<Vector2f>& path) const
+{
+    size_t n = path.size();
+    if(n < 3){
+        return path;
+    }
+
+    std::vector<Vector2f> result = {path[0]};
+    size_t i = 0;
+    while(i < n - 1){
+        // good is reachable from i, bad is not (n when no blocked waypoint was found). The path's
+        // own edge to i + 1 is known to be free.
+        size_t good = i + 1;
+        size_t bad = n;
+        for(size_t step = 2; good < n - 1; step *= 2){
+            size_t j = std::min(i + step, n - 1);
+            if(!visible(path[i], path[j])){
+                bad = j;
+                break;
+            }
+            good = j;
+        }
+        while(bad - good > 1){
+            size_t mid = good + (bad - good) / 2;
+            if(visible(path[i], path[mid])){
+                good = mid;
+            }else{
+                bad = mid;
+            }
+        }
+        result.push_back(path[good]);
+        i = good;
+    }
+    return result;
+}
+
+std::vector<Vector2f> PathOptimizer::shortcutRandom(std::vector<Vector2f> path, int attempts)
+{
+    if(path.size() < 3){
+        return path;
+    }
+
+    // length[i] is the distance along the path to waypoint i, redone after every change.
+    std::vector<float> length;
+    auto measure = [&](){
+        length.assign(1, 0.0f);
+        for(size_t i = 1; i < path.size(); i++){
+            length.push_back(length.back() + Distance(path[i - 1], path[i]));
+        }
+    };
+    measure();
+
+    std::vector<Vector2f> shortened;
+    for(int attempt = 0; attempt < attempts && path.size() > 2; attempt++){
+        std::uniform_real_distribution<float> along(0, length.back());
+        float s1 = along(m_rng);
+        float s2 = along(m_rng);
+        if(s1 > s2){
+            std::swap(s1, s2);
+        }
+
+        // Edges holding the two points, and the points themselves.
+        size_t e1 = std::upper_bound(length.begin(), length.end(), s1) - length.begin() - 1;
+        size_t e2 = std::upper_bound(length.begin(), length.end(), s2) - length.begin() - 1;
+        e1 = std::min(e1, path.size() - 2);
+        e2 = std::min(e2, path.size() - 2);
+        if(e1 == e2){
+            // Both on one straight edge, nothing to gain.
+            continue;
+        }
+        Vector2f p1 = Lerp(path[e1], path[e1 + 1], (s1 - length[e1]) / (length[e1 + 1] - length[e1]));
+        Vector2f p2 = Lerp(path[e2], path[e2 + 1], (s2 - length[e2]) / (length[e2 + 1] - length[e2]));
+
+        // Only worth it if it saves something beyond rounding.
+        if(Distance(p1, p2) >= (s2 - s1) * 0.999f || !visible(p1, p2)){
+            continue;
+        }
+
+        shortened.assign(path.begin(), path.begin() + e1 + 1);
+        shortened.push_back(p1);
+        shortened.push_back(p2);
+        shortened.insert(shortened.end(), path.begin() + e2 + 1, path.end());
+        path.swap(shortened);
+        measure();
+    }
+    return path;
+}
+
+std::vector<Vector2f> PathOptimizer::smooth(const std::vector<Vector2f>& path, int samplesPerEdge) const
+{
+    size_t n = path.size();
+    if(n < 3 || samplesPerEdge < 2){
+        return path;
+    }
+
+    std::vector<Vector2f> result = {path[0]};
+    std::vector<Vector2f> curve;
+    for(size_t i = 0; i + 1 < n; i++){
+        // The end points have no neighbor beyond them, reflect the next one instead.
+        const Vector2f& p1 = path[i];
+        const Vector2f& p2 = path[i + 1];
+        Vector2f p0 = i > 0 ? path[i - 1] : p1 + (p1 - p2);
+        Vector2f p3 = i + 2 < n ? path[i + 2] : p2 + (p2 - p1);
+
+        // Centripetal knots, spaced by the square root of each edge's length.
+        float t0 = 0;
+        float t1 = t0 + std::sqrt(Distance(p0, p1));
+        float t2 = t1 + std::sqrt(Distance(p1, p2));
+        float t3 = t2 + std::sqrt(Distance(p2, p3));
+
+        bool curved = t1 > t0 && t2 > t1 && t3 > t2;
+        curve.clear();
+        if(curved){
+            Vector2f previous = p1;
+            for(int k = 1; k < samplesPerEdge && curved; k++){
+                Vector2f p = CatmullRom(p0, p1, p2, p3, t0, t1, t2, t3, t1 + (t2 - t1) * k / samplesPerEdge);
+                curved = visible(previous, p);
+                curve.push_back(p);
+                previous = p;
+            }
+            curved = curved && visible(previous, p2);
+        }
+
+        // Keep the straight edge where the curve is blocked or undefined.
+        if(curved){
+            result.insert(result.end(), curve.begin(), curve.end());
+        }
+        result.push_back(p2);
+    }
+    return result;
+}
+
+std::vector<Vector2f> PathOptimizer::optimize(const std::vector<Vector2f>& path, bool smoothing, int attempts, OptimizationReport* report)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Vector2f> result = shortcutRandom(shortcutGreedy(path), attempts);
+    float costShortcut = PathCost(result);
+    if(smoothing){
+        result = smooth(result);
+    }
+
+    if(report != nullptr){
+        report->costBefore = PathCost(path);
+        report->costShortcut = costShortcut;
+        report->costAfter = PathCost(result);
+        report->waypointsBefore = path.size();
+        report->waypointsAfter = result.size();
+        report->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+}
@@ -1,19 +1,50 @@
 #include "Polygon.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
 #include <iostream>
+#include <unordered_map>
+#include <numeric>
+#include <stdexcept>
 
-Polygon::Polygon(std::vector<Vertex> input_vertices) : vertices(input_vertices)
+Polygon::Polygon(std::vector<Vertex> input_vertices) : vertices(std::move(input_vertices))
 {
-    for (int i = 0; i < vertices.size(); i++){
-        vertexIndices.push_back(i);
+    vertexIndices.resize(vertices.size());
+    std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
+}
+
+Polygon::Polygon(std::vector<Vertex> input_vertices, std::vector<int> input_triangleIndices)
+    : Polygon(std::move(input_vertices))
+{
+    if(input_triangleIndices.size() % 3 != 0){
+        throw std::invalid_argument("Triangle indices must come in groups of three.");
+    }
+
+    triangleIndices = std::move(input_triangleIndices);
+    triangles.reserve(triangleIndices.size() / 3);
+    for(size_t i = 0; i < triangleIndices.size(); i += 3){
+        triangles.push_back({vertices.at(triangleIndices[i]),
+                             vertices.at(triangleIndices[i + 1]),
+                             vertices.at(triangleIndices[i + 2])});
     }
 }
 
-bool Polygon::contains(const Vector2f& point)
+bool Polygon::contains(const Vector2f& point) const
 {
     if(triangles.empty()){
         throw UnTriangulatedPolygon();
     }
-    for(Triangle t: triangles){
+    if(!convexParts.empty()){
+        for(const std::vector<Vertex>& part : convexParts){
+            if(PointInConvexPolygon(point, part)){
+                return true;
+            }
+        }
+        return false;
+    }
+    for(const Triangle& t: triangles){
         if (PointInTriangle(point, t[0], t[1], t[2])){
             return true;
         }
@@ -21,12 +52,20 @@ bool Polygon::contains(const Vector2f& point)
     return false;
 }
 
-bool Polygon::containsSegment(const Vector2f& a, const Vector2f& b)
+bool Polygon::containsSegment(const Vector2f& a, const Vector2f& b) const
 {
     if(triangles.empty()){
         throw UnTriangulatedPolygon();
     }
-    for(Triangle t: triangles){
+    if(!convexParts.empty()){
+        for(const std::vector<Vertex>& part : convexParts){
+            if(SegmentInConvexPolygon(a, b, part)){
+                return true;
+            }
+        }
+        return false;
+    }
+    for(const Triangle& t: triangles){
         if (SegmentInTriangle(a, b, t)){
             return true;
         }
@@ -56,12 +95,9 @@ void Polygon::TriangulateEarClipping()
             Vertex prev = vertices.at(b);
             Vertex next = vertices.at(c);
 
-            Vector2f check_to_next = next - check;
-            Vector2f check_to_prev = prev - check;
-
             // If cross product < 0, angle at check vertex (moving from previous to the next)
             // is over 180 degrees, this vertex is not valid as an ear so continue to next.
-            if(Cross(check_to_prev, check_to_next) < 0.0f){
+            if(Orient2D(check, prev, next) < 0){
                 continue;
             }
 
@@ -83,12 +119,442 @@ void Polygon::TriangulateEarClipping()
             if (isEar){
                 Triangle add{check, prev, next};
                 triangles.push_back(add);
+                triangleIndices.insert(triangleIndices.end(), {a, b, c});
                 indices.erase(indices.begin() + i);
                 break;
             }
         }
     }
 
-    // Add the final remaining triangle.
-    triangles.push_back({vertices[indices[0]], vertices[indices[1]], vertices[indices[2]]});
-}
\ No newline at end of file
+    // Add the final remaining triangle, ordered as check, previous, next like the others.
+    triangles.push_back({vertices[indices[1]], vertices[indices[0]], vertices[indices[2]]});
+    triangleIndices.insert(triangleIndices.end(), {indices[1], indices[0], indices[2]});
+}
+
+
+namespace {
+
+// The sweep visits vertices from top to bottom, ties broken from left to right. This
+// acts like a tiny rotation of the plane so no two vertices share a height.
+bool Above(const Vector2f& a, const Vector2f& b)
+{
+    return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+
+enum class VertexType{START, END, SPLIT, MERGE, REGULAR};
+
+/// Splits a simple polygon into y-monotone pieces with a top to bottom plane sweep,
+/// then triangulates each piece with the linear time stack algorithm. Works on the
+/// polygon in counter clockwise order, vertex k is followed by k + 1 and edge k joins
+/// vertex k to vertex k + 1.
+class MonotoneTriangulator{
+public:
+    MonotoneTriangulator(const std::vector<Vertex>& vertices){
+        int n = vertices.size();
+
+        // Shoelace sum, positive for counter clockwise input.
+        double area = 0;
+        for(int i = 0, j = n - 1; i < n; j = i++){
+            area += (double)vertices[j].x * vertices[i].y - (double)vertices[i].x * vertices[j].y;
+        }
+
+        m_points.reserve(n);
+        m_original.reserve(n);
+        for(int k = 0; k < n; k++){
+            int i = area >= 0 ? k : n - 1 - k;
+            m_points.push_back(vertices[i]);
+            m_original.push_back(i);
+        }
+    }
+
+    void triangulate(std::vector<int>& out){
+        out.reserve(out.size() + 3 * (m_points.size() - 2));
+        findDiagonals();
+        for(std::vector<int>& piece : splitPieces()){
+            triangulateMonotone(piece, out);
+        }
+    }
+
+private:
+    std::vector<Vertex> m_points;          //< Polygon in counter clockwise order.
+    std::vector<int> m_original;           //< Index of each point in the caller's vertices.
+    std::vector<std::pair<int, int>> m_diagonals;
+
+    int size() const { return m_points.size(); }
+    int next(int k) const { return k + 1 == size() ? 0 : k + 1; }
+    int prev(int k) const { return k == 0 ? size() - 1 : k - 1; }
+
+    VertexType classify(int k) const{
+        const Vector2f& p = m_points[prev(k)];
+        const Vector2f& v = m_points[k];
+        const Vector2f& q = m_points[next(k)];
+        bool convex = Orient2D(p, v, q) > 0;
+
+        if(Above(v, p) && Above(v, q)){
+            return convex ? VertexType::START : VertexType::SPLIT;
+        }
+        if(Above(p, v) && Above(q, v)){
+            return convex ? VertexType::END : VertexType::MERGE;
+        }
+        return VertexType::REGULAR;
+    }
+
+    // Sweep line status: the edges crossing the sweep line that have the polygon interior
+    // to their right, ordered left to right by where they cross it.
+    struct Status{
+        const MonotoneTriangulator* owner;
+        const Vector2f* sweep;     //< Vertex the sweep line is currently at.
+
+        using is_transparent = void;
+
+        // Where edge e crosses the sweep line. Horizontal edges are treated as
+        // very slightly tilted, consistent with Above, so they cross at the sweep vertex.
+        double crossing(int e) const{
+            const Vector2f& a = owner->m_points[e];
+            const Vector2f& b = owner->m_points[owner->next(e)];
+            if(a.y == b.y){
+                return std::clamp((double)sweep->x, (double)std::min(a.x, b.x), (double)std::max(a.x, b.x));
+            }
+            const Vector2f& upper = Above(a, b) ? a : b;
+            const Vector2f& lower = Above(a, b) ? b : a;
+            return upper.x + ((double)sweep->y - upper.y) * ((double)lower.x - upper.x) / ((double)lower.y - upper.y);
+        }
+
+        bool operator()(int a, int b) const { return crossing(a) < crossing(b); }
+        bool operator()(int a, const Vector2f& p) const { return crossing(a) < p.x; }
+        bool operator()(const Vector2f& p, int b) const { return p.x < crossing(b); }
+    };
+
+    void findDiagonals(){
+        int n = size();
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b){ return Above(m_points[a], m_points[b]); });
+
+        std::vector<VertexType> types(n);
+        for(int k = 0; k < n; k++){
+            types[k] = classify(k);
+        }
+
+        Vector2f sweep;
+        std::set<int, Status> status(Status{this, &sweep});
+        std::vector<std::set<int, Status>::iterator> inStatus(n, status.end());
+        std::vector<int> helper(n, -1);
+
+        auto insertEdge = [&](int e, int v){
+            inStatus[e] = status.insert(e).first;
+            helper[e] = v;
+        };
+        auto removeEdge = [&](int e, int v){
+            if(helper[e] != -1 && types[helper[e]] == VertexType::MERGE){
+                m_diagonals.push_back({v, helper[e]});
+            }
+            if(inStatus[e] != status.end()){
+                status.erase(inStatus[e]);
+                inStatus[e] = status.end();
+            }
+        };
+        // Edge directly to the left of v on the sweep line.
+        auto leftOf = [&](int v){
+            auto it = status.upper_bound(m_points[v]);
+            if(it == status.begin()){
+                throw std::invalid_argument("Polygon is not simple, unable to triangulate.");
+            }
+            return *std::prev(it);
+        };
+        auto updateLeft = [&](int v){
+            int e = leftOf(v);
+            if(types[helper[e]] == VertexType::MERGE){
+                m_diagonals.push_back({v, helper[e]});
+            }
+            helper[e] = v;
+        };
+
+        for(int v : order){
+            sweep = m_points[v];
+            switch(types[v]){
+                case VertexType::START:
+                    insertEdge(v, v);
+                    break;
+                case VertexType::END:
+                    removeEdge(prev(v), v);
+                    break;
+                case VertexType::SPLIT:{
+                    int e = leftOf(v);
+                    m_diagonals.push_back({v, helper[e]});
+                    helper[e] = v;
+                    insertEdge(v, v);
+                    break;
+                }
+                case VertexType::MERGE:
+                    removeEdge(prev(v), v);
+                    updateLeft(v);
+                    break;
+                case VertexType::REGULAR:
+                    // Walking down the left boundary the interior lies to the right.
+                    if(Above(m_points[prev(v)], m_points[v])){
+                        removeEdge(prev(v), v);
+                        insertEdge(v, v);
+                    }else{
+                        updateLeft(v);
+                    }
+                    break;
+            }
+        }
+    }
+
+    // Walk the faces formed by the polygon edges and diagonals, each one is a y-monotone
+    // piece listed in counter clockwise order.
+    std::vector<std::vector<int>> splitPieces() const{
+        int n = size();
+        if(m_diagonals.empty()){
+            std::vector<int> all(n);
+            std::iota(all.begin(), all.end(), 0);
+            return {all};
+        }
+
+        // Outgoing half edges at each vertex, sorted by angle. The reversed polygon edges
+        // border the outside and are left out.
+        std::vector<std::vector<std::pair<double, int>>> outgoing(n);
+        auto angle = [&](int from, int to){
+            return std::atan2((double)m_points[to].y - m_points[from].y, (double)m_points[to].x - m_points[from].x);
+        };
+        for(int k = 0; k < n; k++){
+            outgoing[k].push_back({angle(k, next(k)), next(k)});
+        }
+        for(auto [a, b] : m_diagonals){
+            outgoing[a].push_back({angle(a, b), b});
+            outgoing[b].push_back({angle(b, a), a});
+        }
+        for(auto& edges : outgoing){
+            std::sort(edges.begin(), edges.end());
+        }
+
+        // Arriving at v from u, the face continues along the first edge clockwise from v to u.
+        auto following = [&](int u, int v){
+            const auto& edges = outgoing[v];
+            if(edges.size() == 1){
+                return edges[0].second;
+            }
+            double back = angle(v, u);
+            auto it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(back, -1));
+            if(it == edges.begin()){
+                it = edges.end();
+            }
+            return std::prev(it)->second;
+        };
+
+        std::set<std::pair<int, int>> visited;
+        std::vector<std::vector<int>> pieces;
+        auto walk = [&](int u, int v){
+            if(!visited.insert({u, v}).second){
+                return;
+            }
+            std::vector<int> piece{u};
+            while(v != piece.front()){
+                piece.push_back(v);
+                int w = following(u, v);
+                u = v;
+                v = w;
+                visited.insert({u, v});
+            }
+            pieces.push_back(std::move(piece));
+        };
+
+        for(auto [a, b] : m_diagonals){
+            walk(a, b);
+            walk(b, a);
+        }
+        return pieces;
+    }
+
+    void emit(int a, int b, int c, std::vector<int>& out) const{
+        int area = Orient2D(m_points[a], m_points[b], m_points[c]);
+        // Collinear vertices leave slivers without area, they cover nothing.
+        if(area == 0){
+            return;
+        }
+        if(area < 0){
+            std::swap(b, c);
+        }
+        out.insert(out.end(), {m_original[a], m_original[b], m_original[c]});
+    }
+
+    void triangulateMonotone(const std::vector<int>& piece, std::vector<int>& out) const{
+        int count = piece.size();
+        if(count < 3){
+            return;
+        }
+
+        // Going counter clockwise from the top vertex runs down the left chain to the
+        // bottom vertex, the rest of the piece is the right chain.
+        int top = 0;
+        int bottom = 0;
+        for(int i = 1; i < count; i++){
+            if(Above(m_points[piece[i]], m_points[piece[top]])){
+                top = i;
+            }
+            if(Above(m_points[piece[bottom]], m_points[piece[i]])){
+                bottom = i;
+            }
+        }
+        std::vector<std::pair<int, bool>> sorted; //< Vertex and whether it is on the left chain.
+        sorted.reserve(count);
+        for(int i = top; ; i = (i + 1) % count){
+            sorted.push_back({piece[i], i != bottom});
+            if(i == bottom){
+                break;
+            }
+        }
+        for(int i = (bottom + 1) % count; i != top; i = (i + 1) % count){
+            sorted.push_back({piece[i], false});
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](const auto& a, const auto& b){
+            return Above(m_points[a.first], m_points[b.first]);
+        });
+
+        std::vector<std::pair<int, bool>> stack{sorted[0], sorted[1]};
+        for(int j = 2; j < count - 1; j++){
+            auto [v, left] = sorted[j];
+            if(left != stack.back().second){
+                // Opposite chains: v sees every vertex on the stack.
+                for(size_t k = 0; k + 1 < stack.size(); k++){
+                    emit(v, stack[k].first, stack[k + 1].first, out);
+                }
+                auto last = stack.back();
+                stack = {last, sorted[j]};
+            }else{
+                // Same chain: cut off vertices while the turn towards v is convex.
+                auto last = stack.back();
+                stack.pop_back();
+                while(!stack.empty()){
+                    int turn = Orient2D(m_points[stack.back().first], m_points[last.first], m_points[v]);
+                    if(left ? turn <= 0 : turn >= 0){
+                        break;
+                    }
+                    emit(stack.back().first, last.first, v, out);
+                    last = stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(last);
+                stack.push_back(sorted[j]);
+            }
+        }
+
+        // The bottom vertex sees everything left on the stack.
+        int v = sorted[count - 1].first;
+        for(size_t k = 0; k + 1 < stack.size(); k++){
+            emit(v, stack[k].first, stack[k + 1].first, out);
+        }
+    }
+};
+
+} // namespace
+
+void Polygon::TriangulateMonotone()
+{
+    triangles.clear();
+    triangleIndices.clear();
+
+    if(vertices.size() < 3){
+        return;
+    }
+
+    MonotoneTriangulator(vertices).triangulate(triangleIndices);
+
+    triangles.reserve(triangleIndices.size() / 3);
+    for(size_t i = 0; i < triangleIndices.size(); i += 3){
+        triangles.push_back({vertices[triangleIndices[i]], vertices[triangleIndices[i + 1]], vertices[triangleIndices[i + 2]]});
+    }
+}
+
+void Polygon::DecomposeConvex()
+{
+    if(triangleIndices.empty()){
+        throw UnTriangulatedPolygon();
+    }
+
+    // Half edges of the triangles. Edge h runs from 'from[h]' to the start of 'next[h]'
+    // with its face on the left. Boundary edges have no twin.
+    int count = triangleIndices.size();
+    std::vector<int> from(triangleIndices);
+    std::vector<int> next(count), prev(count), twin(count, -1);
+    std::vector<bool> removed(count, false);
+    std::unordered_map<uint64_t, int> edges;
+    edges.reserve(count);
+
+    auto key = [](int a, int b){ return (uint64_t(uint32_t(a)) << 32) | uint32_t(b); };
+
+    for(int t = 0; t < count; t += 3){
+        for(int k = 0; k < 3; k++){
+            int h = t + k;
+            next[h] = t + (k + 1) % 3;
+            prev[h] = t + (k + 2) % 3;
+        }
+        for(int k = 0; k < 3; k++){
+            int h = t + k;
+            auto found = edges.find(key(from[next[h]], from[h]));
+            if(found != edges.end()){
+                twin[h] = found->second;
+                twin[found->second] = h;
+            }else{
+                edges[key(from[h], from[next[h]])] = h;
+            }
+        }
+    }
+
+    // The turn at 'at' coming from 'before' and leaving towards 'after' must stay convex.
+    auto convex = [&](int before, int at, int after){
+        return Orient2D(vertices[before], vertices[at], vertices[after]) >= 0;
+    };
+
+    for(int h = 0; h < count; h++){
+        int t = twin[h];
+        if(t == -1 || t < h){
+            continue;
+        }
+
+        // Dropping the diagonal u -> v joins the face of h with the face of its twin.
+        int u = from[h];
+        int v = from[t];
+        if(!convex(from[prev[h]], u, from[next[next[t]]]) || !convex(from[prev[t]], v, from[next[next[h]]])){
+            continue;
+        }
+
+        next[prev[h]] = next[t];
+        prev[next[t]] = prev[h];
+        next[prev[t]] = next[h];
+        prev[next[h]] = prev[t];
+        removed[h] = true;
+        removed[t] = true;
+    }
+
+    // Walk each remaining face once to collect the convex pieces.
+    convexParts.clear();
+    std::vector<bool> visited(count, false);
+    for(int h = 0; h < count; h++){
+        if(removed[h] || visited[h]){
+            continue;
+        }
+        std::vector<Vertex> face;
+        for(int e = h; !visited[e]; e = next[e]){
+            visited[e] = true;
+            face.push_back(vertices[from[e]]);
+        }
+
+        // Straight angles add nothing to the piece, dropping them leaves every vertex strictly
+        // convex as the fan search in PointInConvexPolygon needs.
+        std::vector<Vertex> part;
+        for(size_t i = 0; i < face.size(); i++){
+            const Vertex& before = face[(i + face.size() - 1) % face.size()];
+            const Vertex& after = face[(i + 1) % face.size()];
+            if(Orient2D(before, face[i], after) != 0){
+                part.push_back(face[i]);
+            }
+        }
+        if(part.size() >= 3){
+            convexParts.push_back(std::move(part));
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#include "Predicates.hpp"
+
+namespace {
+
+// Error free addition, a + b == sum + error exactly (Knuth's TwoSum).
+inline void TwoSum(double a, double b, double& sum, double& error)
+{
+    sum = a + b;
+    double bVirtual = sum - a;
+    double aVirtual = sum - bVirtual;
+    error = (a - aVirtual) + (b - bVirtual);
+}
+
+} // namespace
+
+int Orient2DExact(const Vector2f& a, const Vector2f& b, const Vector2f& c)
+{
+    // Expanded, the determinant is a sum of six products of two floats. Each product
+    // needs at most 48 bits of mantissa so it is exact in a double, and the range of
+    // double means it cannot overflow or underflow either.
+    const double terms[6] = {
+         (double)a.x * b.y, -(double)a.x * c.y,
+         (double)b.x * c.y, -(double)b.x * a.y,
+         (double)c.x * a.y, -(double)c.x * b.y,
+    };
+
+    // Sum the products exactly as an expansion, a list of non overlapping doubles in
+    // increasing magnitude whose sum is the exact total (Shewchuk's Grow-Expansion).
+    // Zero components are dropped, so there are never more than there are terms.
+    double expansion[6];
+    int length = 0;
+    for(double term : terms){
+        double carry = term;
+        int kept = 0;
+        for(int i = 0; i < length; i++){
+            double sum, error;
+            TwoSum(carry, expansion[i], sum, error);
+            if(error != 0){
+                expansion[kept++] = error;
+            }
+            carry = sum;
+        }
+        if(carry != 0){
+            expansion[kept++] = carry;
+        }
+        length = kept;
+    }
+
+    // The largest component outweighs all the others together, so it carries the sign.
+    if(length == 0){
+        return 0;
+    }
+    return expansion[length - 1] > 0 ? 1 : -1;
+}
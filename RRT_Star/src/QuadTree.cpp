@@ -0,0 +1,192 @@
+#include "QuadTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Smallest cell size allowed, in multiples of the classification margin.
+const float MIN_CELL_MARGINS = 4;
+
+Box inflate(const Box& box, float margin){
+    return {box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin};
+}
+
+// True if the segment from a to b meets the box, clipping it against each pair of sides.
+bool segmentMeetsBox(const Vector2f& a, const Vector2f& b, const Box& box){
+    float t0 = 0;
+    float t1 = 1;
+    const float start[2] = {a.x, a.y};
+    const float delta[2] = {b.x - a.x, b.y - a.y};
+    const float low[2] = {box.minX, box.minY};
+    const float high[2] = {box.maxX, box.maxY};
+    for(int axis = 0; axis < 2; axis++){
+        if(delta[axis] == 0){
+            if(start[axis] < low[axis] || start[axis] > high[axis]){
+                return false;
+            }
+            continue;
+        }
+        float enter = (low[axis] - start[axis]) / delta[axis];
+        float exit = (high[axis] - start[axis]) / delta[axis];
+        if(enter > exit){
+            std::swap(enter, exit);
+        }
+        t0 = std::max(t0, enter);
+        t1 = std::min(t1, exit);
+        if(t0 > t1){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Distance between the segment from a to b and the box, for a segment that does not meet it.
+float segmentBoxDistance(const Vector2f& a, const Vector2f& b, const Box& box){
+    const Vector2f corners[4] = {{box.minX, box.minY}, {box.maxX, box.minY}, {box.maxX, box.maxY}, {box.minX, box.maxY}};
+    float distance = SegmentDistance(a, b, corners[3], corners[0]);
+    for(int i = 0; i < 3; i++){
+        distance = std::min(distance, SegmentDistance(a, b, corners[i], corners[i + 1]));
+    }
+    return distance;
+}
+
+} // namespace
+
+OccupancyQuadTree::OccupancyQuadTree(const Obstacles& obs, const Vector2f& lower, const Vector2f& upper, float minCellSize)
+    : m_obs(&obs), m_bounds{lower.x, lower.y, upper.x, upper.y}
+{
+    if(!(minCellSize > 0)){
+        throw std::invalid_argument("Minimum cell size must be positive.");
+    }
+    // A few float steps at the workspace's largest coordinate.
+    float largest = std::max({std::abs(lower.x), std::abs(lower.y), std::abs(upper.x), std::abs(upper.y)});
+    m_epsilon = 1e-5f * std::max(largest, 1.0f);
+    // Cells not much wider than the margin would all classify as mixed and halving them
+    // soon stops changing their float bounds, so splitting ends well above it.
+    m_minCellSize = std::max(minCellSize, MIN_CELL_MARGINS * m_epsilon);
+
+    std::vector<Edge> edges;
+    for(const Polygon& polygon : obs.polygons()){
+        const std::vector<Vertex>& v = polygon.vertices;
+        for(size_t i = 0; i < v.size(); i++){
+            edges.push_back({v[i], v[(i + 1) % v.size()]});
+        }
+    }
+    m_nodes.push_back(Node::Leaf(Occupancy::MIXED));
+    build(0, m_bounds, edges);
+    m_nodes.shrink_to_fit();
+}
+
+void OccupancyQuadTree::build(int node, const Box& box, const std::vector<Edge>& edges)
+{
+    // Only the boundary can separate the inside of an obstacle from the outside, so a cell it
+    // stays clear of, by a margin for rounding, is all one or the other, as its center is.
+    Box margin = inflate(box, m_epsilon);
+    std::vector<Edge> crossing;
+    for(const Edge& e : edges){
+        if(segmentMeetsBox(e.a, e.b, margin)){
+            crossing.push_back(e);
+        }
+    }
+    if(crossing.empty()){
+        Vector2f center(0.5f * (box.minX + box.maxX), 0.5f * (box.minY + box.maxY));
+        m_nodes[node] = Node::Leaf(m_obs->inObstacles(center) ? Occupancy::FULL : Occupancy::FREE);
+        return;
+    }
+    if(box.maxX - box.minX <= m_minCellSize && box.maxY - box.minY <= m_minCellSize){
+        m_nodes[node] = Node::Leaf(Occupancy::MIXED);
+        return;
+    }
+
+    int children = m_nodes.size();
+    m_nodes[node].value = children;
+    m_nodes.resize(m_nodes.size() + 4, Node::Leaf(Occupancy::MIXED));
+    for(int i = 0; i < 4; i++){
+        build(children + i, quarter(box, i), crossing);
+    }
+}
+
+Occupancy OccupancyQuadTree::occupancy(const Vector2f& p) const
+{
+    if(!m_bounds.contains(p)){
+        return Occupancy::MIXED;
+    }
+    int node = 0;
+    Box box = m_bounds;
+    while(!m_nodes[node].leaf()){
+        float midX = 0.5f * (box.minX + box.maxX);
+        float midY = 0.5f * (box.minY + box.maxY);
+        int i = (p.x >= midX ? 1 : 0) | (p.y >= midY ? 2 : 0);
+        node = m_nodes[node].value + i;
+        box = quarter(box, i);
+    }
+    return m_nodes[node].occupancy();
+}
+
+Occupancy OccupancyQuadTree::occupancy(const Vector2f& a, const Vector2f& b, float radius) const
+{
+    Box reach = {std::min(a.x, b.x) - radius - m_epsilon, std::min(a.y, b.y) - radius - m_epsilon,
+                 std::max(a.x, b.x) + radius + m_epsilon, std::max(a.y, b.y) + radius + m_epsilon};
+    bool mixed = !(m_bounds.contains({reach.minX, reach.minY}) && m_bounds.contains({reach.maxX, reach.maxY}));
+
+    // Start from the smallest cell holding everything the disc can reach.
+    int node = 0;
+    Box box = m_bounds;
+    while(!m_nodes[node].leaf()){
+        float midX = 0.5f * (box.minX + box.maxX);
+        float midY = 0.5f * (box.minY + box.maxY);
+        bool low = reach.maxX < midX;
+        bool left = reach.maxY < midY;
+        if(!(low || reach.minX > midX) || !(left || reach.minY > midY)){
+            break;
+        }
+        int i = (low ? 0 : 1) | (left ? 0 : 2);
+        node = m_nodes[node].value + i;
+        box = quarter(box, i);
+    }
+
+    if(collect(node, box, a, b, radius, mixed)){
+        return Occupancy::FULL;
+    }
+    return mixed ? Occupancy::MIXED : Occupancy::FREE;
+}
+
+bool OccupancyQuadTree::collect(int node, const Box& box, const Vector2f& a, const Vector2f& b, float radius, bool& mixed) const
+{
+    const Node& n = m_nodes[node];
+    if(n.leaf() && n.occupancy() == Occupancy::FREE){
+        return false;
+    }
+    // Square corners reach a little further than the disc does, which can only add cells.
+    if(!segmentMeetsBox(a, b, inflate(box, radius + m_epsilon))){
+        return false;
+    }
+    if(n.leaf()){
+        if(n.occupancy() == Occupancy::MIXED){
+            mixed = true;
+            return false;
+        }
+        // Near a corner the disc may pass the full cell by, so measure the distance. The
+        // margin around a full cell is inside the obstacle too.
+        Box margin = inflate(box, m_epsilon);
+        return radius <= 0 || segmentMeetsBox(a, b, margin) || segmentBoxDistance(a, b, margin) <= radius;
+    }
+    for(int i = 0; i < 4; i++){
+        if(collect(n.value + i, quarter(box, i), a, b, radius, mixed)){
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t OccupancyQuadTree::leafCount(Occupancy occupancy) const
+{
+    size_t count = 0;
+    for(const Node& n : m_nodes){
+        count += n.leaf() && n.occupancy() == occupancy;
+    }
+    return count;
+}
@@ -0,0 +1,75 @@
+#include "UniformGrid.hpp"
+
+#include <cmath>
+#include <limits>
+
+Box Box::Around(const std::vector<Vector2f>& points)
+{
+    Box box = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+               std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for(const Vector2f& p : points){
+        box.minX = std::min(box.minX, p.x);
+        box.minY = std::min(box.minY, p.y);
+        box.maxX = std::max(box.maxX, p.x);
+        box.maxY = std::max(box.maxY, p.y);
+    }
+    return box;
+}
+
+void UniformGrid::build(const std::vector<Box>& boxes)
+{
+    // Roughly this many cells per shape, and never more cells than this in total.
+    const float CELLS_PER_ITEM = 4;
+    const int MAX_CELLS = 1 << 20;
+
+    m_items.clear();
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_cols = 0;
+    m_rows = 0;
+    if(boxes.empty()){
+        return;
+    }
+
+    m_bounds = boxes[0];
+    for(const Box& box : boxes){
+        m_bounds.minX = std::min(m_bounds.minX, box.minX);
+        m_bounds.minY = std::min(m_bounds.minY, box.minY);
+        m_bounds.maxX = std::max(m_bounds.maxX, box.maxX);
+        m_bounds.maxY = std::max(m_bounds.maxY, box.maxY);
+    }
+
+    float width = std::max(m_bounds.maxX - m_bounds.minX, 1e-3f);
+    float height = std::max(m_bounds.maxY - m_bounds.minY, 1e-3f);
+    float cells = std::min<float>(CELLS_PER_ITEM * boxes.size(), MAX_CELLS);
+    m_cellSize = std::sqrt(width * height / cells);
+    m_cols = std::clamp(int(width / m_cellSize) + 1, 1, MAX_CELLS);
+    m_rows = std::clamp(int(height / m_cellSize) + 1, 1, MAX_CELLS / m_cols);
+
+    for(const Box& box : boxes){
+        m_items.push_back({box, column(box.minX), column(box.maxX), row(box.minY), row(box.maxY)});
+    }
+
+    // Count the shapes in each cell, then fill the cells in one flat array.
+    m_cellStart.assign(m_cols * m_rows + 1, 0);
+    for(const Item& item : m_items){
+        for(int r = item.firstRow; r <= item.lastRow; r++){
+            for(int c = item.firstColumn; c <= item.lastColumn; c++){
+                m_cellStart[r * m_cols + c + 1]++;
+            }
+        }
+    }
+    for(size_t i = 1; i < m_cellStart.size(); i++){
+        m_cellStart[i] += m_cellStart[i - 1];
+    }
+    m_cellItems.resize(m_cellStart.back());
+    std::vector<int> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    for(size_t i = 0; i < m_items.size(); i++){
+        const Item& item = m_items[i];
+        for(int r = item.firstRow; r <= item.lastRow; r++){
+            for(int c = item.firstColumn; c <= item.lastColumn; c++){
+                m_cellItems[fill[r * m_cols + c]++] = i;
+            }
+        }
+    }
+}
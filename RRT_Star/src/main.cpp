@@ -12,9 +12,14 @@
 #include <numeric> // for iota
 #include <algorithm>
 #include <cstdlib>
+#include <string>
+#include <thread>
 
 #include "Math.hpp"
 #include "RRT.hpp"
+#include "PathOptimizer.hpp"
+#include "SpscQueue.hpp"
+#include "TreeDeltas.hpp"
 
 #include <chrono>
 using namespace std::chrono;
@@ -29,6 +34,7 @@ int main(int argc, char* argv[]){
     int neigbordoodRadius = 50;
     int rho = 30;
     int maxIterations = 3000;
+    float robotRadius = 4;
 
     // Ensure that a file with obstacles has been provided
     if(argc < 2){
@@ -36,6 +42,19 @@ int main(int argc, char* argv[]){
         std::cout << "e.g. ./prog points.txt" << std::endl;
         std::cout << "Alternately provide additonal arguments for start and goal to override defaults." << std::endl;
         std::cout << "e.g. ./prog points.txt <start_position_x> <start_position_y> <goal_position_x> <goal_position_y <goal_radius>" << std::endl;
+        std::cout << "To convert an obstacle file to the faster loading binary format:" << std::endl;
+        std::cout << "e.g. ./prog --convert points.txt points.obs" << std::endl;
+        return 0;
+    }
+
+    // Convert a text obstacle file to the binary format and exit.
+    if(std::string(argv[1]) == "--convert"){
+        if(argc != 4){
+            std::cout << "e.g. ./prog --convert points.txt points.obs" << std::endl;
+            return 0;
+        }
+        Obstacles(argv[2]).saveBinary(argv[3]);
+        std::cout << "Wrote binary obstacles to: " << argv[3] << std::endl;
         return 0;
     }
 
@@ -54,11 +73,46 @@ int main(int argc, char* argv[]){
 
     // Initialize the obstacles with provided input file
     Obstacles obs = Obstacles(argv[1]);
+    obs.decomposeConvex();
+
+    // The robot is a disc, most of whose motions the distance field proves clear without
+    // testing them against the polygons.
+    DistanceField field(obs, 640, 480);
+    RRTStarDisc rrt = RRTStarDisc(Vector2f(0, 0), Vector2f(640, 480), ClearanceCollision<2, float>(obs, field, robotRadius),
+                                  start, goal, goalRadius, 70, 30, maxIterations);
+
+    // The planner runs on its own thread and streams each change to its tree through this
+    // queue, so the window shows the search growing instead of waiting for the final tree.
+    SpscQueue<TreeDelta<Vector2f>> deltas(1 << 16);
+    TreeDeltaLog<Vector2f> deltaLog(deltas);
+    rrt.setDeltaLog(&deltaLog);
+
+    // Shortcut copy of the planner's path, written by the planner thread before
+    // it publishes DONE, so the viewer may read it once its mirror of the tree is done.
+    std::vector<Vector2f> optimizedPath;
+
+    std::jthread planner([&](std::stop_token stop){
+        // Same search as findBestPath, but closing the window stops it early.
+        rrt.beginSearch(true);
+        if(rrt.step(maxIterations, stop) == PlanStatus::CANCELLED){
+            return;
+        }
+        std::cout << "Path found of length: " << rrt.getCost() << std::endl;
+
+        if(rrt.hasPath()){
+            OptimizationReport report;
+            // Smoothing rounds the corners at the cost of a slightly longer path, so only shortcut.
+            optimizedPath = PathOptimizer(obs, robotRadius).optimize(rrt.bestPath(), false, 200, &report);
+            std::cout << "Optimized path length: " << report.costBefore << " -> " << report.costAfter
+                      << " shortcut, in " << report.milliseconds << " ms" << std::endl;
+        }
+        deltaLog.publish({TreeDelta<Vector2f>::Type::DONE, -1, -1, {}});
 
-    RRTStar rrt = RRTStar(640, 480, obs, start, goal, goalRadius, 70, 30);
-
-    rrt.findBestPath();
-    std::cout << "Path found of length: " << rrt.getCost() << std::endl;
+        // Hand over whatever the viewer has not had room for yet, unless it was closed.
+        while(!deltaLog.flush() && !stop.stop_requested()){
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    });
 
     // SDL initialization
     if(SDL_Init(SDL_INIT_VIDEO) < 0){
@@ -72,46 +126,114 @@ int main(int argc, char* argv[]){
     SDL_Window* window=nullptr;
     window = SDL_CreateWindow("C++ SDL2 Window",20, 20, 640, 480,SDL_WINDOW_SHOWN);
 
-    // Create SDL renderer
+    // Create SDL renderer, presenting in step with the display's refresh and able to
+    // render into the cached layer textures.
     SDL_Renderer* renderer = nullptr;
-    renderer = SDL_CreateRenderer(window,-1,SDL_RENDERER_ACCELERATED);
+    renderer = SDL_CreateRenderer(window,-1,SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE);
 
     // Allows for alpha values 
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 
-    bool visualization = true;
+    // Scoped so the layer textures are released before the renderer that owns them.
+    {
+        // The obstacles never change and the tree mostly grows, so they are drawn into textures
+        // and each frame only copies them to the window, after adding any new tree nodes.
+        CachedLayer obstacleLayer;
+        CachedLayer treeLayer;
+        GeometryBatch batch;
+
+        // The viewer's copy of the planner's tree, and how much of it the tree layer shows.
+        TreeMirror<Vector2f> tree;
+        size_t drawnNodes = 0;
+        Uint32 lastFullPaint = 0;
+        const int FRAME_MS = 16;
+        const Uint32 FULL_PAINT_MS = 200;
+
+        bool visualization = true;
+        bool redraw = true;
+
+        // Loop to draw visualization
+        while(visualization){
+            SDL_Event event;
+
+            // While the planner runs, wake up every frame to pick up its progress. Once it is
+            // done nothing changes on screen between events, so sleep until the next one rather
+            // than redrawing in a busy loop. Then handle everything that queued up meanwhile.
+            bool gotEvent = tree.done() ? SDL_WaitEvent(&event) : SDL_WaitEventTimeout(&event, FRAME_MS);
+            if(gotEvent){
+                do{
+                    if(event.type == SDL_QUIT){
+                        // Quit the visualization
+                        visualization= false;
+                    }else if(event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET){
+                        // Texture contents were lost.
+                        obstacleLayer.invalidate();
+                        treeLayer.invalidate();
+                        redraw = true;
+                    }else if(event.type == SDL_WINDOWEVENT){
+                        redraw = true;
+                    }
+                }while(SDL_PollEvent(&event));
+            }
 
-    // Loop to draw visualization
-    while(visualization){
-        SDL_Event event;
+            if(tree.drain(deltas)){
+                redraw = true;
+            }
 
-        // Quit the visualization
-        while(SDL_PollEvent(&event)){
-            if(event.type == SDL_QUIT){
-                visualization= false;
+            if(!visualization || !redraw){
+                continue;
             }
-        }
         
-        // Set the backgorund of drawing
-        SDL_SetRenderDrawColor(renderer,0,0,0,SDL_ALPHA_OPAQUE);
-        SDL_RenderClear(renderer);
-
-        // Draw the set of obstacles
-        SDL_SetRenderDrawColor(renderer,152,115,172,SDL_ALPHA_OPAQUE);
-        obs.draw(renderer);
-
-        // Draw the tree generated
-        rrt.drawTree(renderer);
-
-        //Draw the retrieved path
-        rrt.drawPath(renderer);
+            // Set the backgorund of drawing
+            SDL_SetRenderDrawColor(renderer,0,0,0,SDL_ALPHA_OPAQUE);
+            SDL_RenderClear(renderer);
+
+            // Draw the set of obstacles
+            obstacleLayer.render(renderer, [&](SDL_Renderer* target){
+                SDL_SetRenderDrawColor(target,152,115,172,SDL_ALPHA_OPAQUE);
+                obs.draw(target);
+            });
+
+            // Rewired edges can only be erased by painting the whole tree again, which is limited
+            // to a few times a second while the planner runs. New nodes are just added on top.
+            if(tree.restructured() && (tree.done() || SDL_GetTicks() - lastFullPaint >= FULL_PAINT_MS)){
+                treeLayer.invalidate();
+                tree.clearRestructured();
+            }
+            treeLayer.paintOver(renderer, [&](SDL_Renderer* target){
+                batch.clear();
+                tree.drawNodes(batch, drawnNodes);
+                batch.render(target);
+            });
+            treeLayer.render(renderer, [&](SDL_Renderer* target){
+                batch.clear();
+                tree.drawNodes(batch, 0);
+                batch.render(target);
+                lastFullPaint = SDL_GetTicks();
+            });
+            drawnNodes = tree.size();
+
+            // Draw the best path so far over the tree.
+            batch.clear();
+            tree.drawPath(batch);
+            if(tree.done()){
+                for(size_t i = 1; i < optimizedPath.size(); i++){
+                    const Vector2f& a = optimizedPath[i - 1];
+                    const Vector2f& b = optimizedPath[i];
+                    batch.addLine(a.x, a.y, b.x, b.y, {240,190,40,250}, 2);
+                }
+            }
+            batch.render(renderer);
 
-        // Draw the goal region for reference.
-        drawDottedCircle(renderer, goal, goalRadius);
+            // Draw the goal region for reference.
+            drawDottedCircle(renderer, goal, goalRadius);
 
-        SDL_RenderPresent(renderer);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
     }
 
+    SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 